@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include <sys/resource.h>
+
+// helpers shared by the benchmarks. each benchmark is its own executable, printing a line per measurement.
+
+namespace looper::bench {
+
+class stopwatch {
+public:
+    stopwatch()
+        : m_wall_start(std::chrono::steady_clock::now())
+        , m_cpu_start(cpu_time())
+    {}
+
+    [[nodiscard]] double wall_seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_wall_start).count();
+    }
+
+    // cpu time of the whole process, including the loop thread
+    [[nodiscard]] double cpu_seconds() const {
+        return cpu_time() - m_cpu_start;
+    }
+
+private:
+    static double cpu_time() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+            static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    std::chrono::steady_clock::time_point m_wall_start;
+    double m_cpu_start;
+};
+
+inline void report(const char* name, const size_t count, const char* unit, const stopwatch& watch) {
+    const auto wall = watch.wall_seconds();
+    const auto cpu = watch.cpu_seconds();
+    printf("%-40s %10lu %-10s %9.1f ms %12.0f %s/s %9.1f ms cpu\n",
+           name, count, unit, wall * 1000, static_cast<double>(count) / wall, unit, cpu * 1000);
+    fflush(stdout);
+}
+
+template<typename pred_>
+bool wait_for(pred_&& pred, const std::chrono::milliseconds timeout = std::chrono::seconds(10)) {
+    const auto end = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() >= end) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,121 @@
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <looper.h>
+
+#include "bench.h"
+
+using namespace looper::bench;
+
+static constexpr uint16_t base_port = 47321;
+static constexpr size_t connections = 64;
+static constexpr size_t message_size = 64;
+
+struct echo_client {
+    looper::tcp tcp = looper::empty_handle;
+    size_t received = 0;
+    size_t left = 0;
+};
+
+// many connections, each sending a small message and waiting for it to be echoed back before sending the next.
+// every round trip needs the poller to report readiness on both ends, so this mostly measures the cost of polling
+// and changing the watched events.
+static void bench_echo(const bool edge_triggered, const uint16_t port, const size_t round_trips) {
+    looper::loop_options options{};
+    options.edge_triggered_io = edge_triggered;
+    const auto loop = looper::create(options);
+    looper::exec_in_thread(loop);
+
+    std::atomic<size_t> accepted_count{0};
+    std::vector<looper::tcp> accepted(connections, looper::empty_handle);
+
+    const auto server = looper::create_tcp_server(loop);
+    looper::bind_tcp_server(server, "127.0.0.1", port);
+    looper::listen_tcp(server, connections, [&](const looper::tcp_server tcp_server) {
+        const auto tcp = looper::accept_tcp(tcp_server);
+        looper::start_tcp_read(tcp, [](const looper::tcp tcp, const std::span<const uint8_t> data, const looper::error error) {
+            if (error == looper::error_success) {
+                looper::write_tcp(tcp, std::vector<uint8_t>(data.begin(), data.end()), [](looper::tcp, looper::error) {});
+            }
+        });
+        accepted[accepted_count++] = tcp;
+    });
+
+    auto message = std::make_shared_for_overwrite<uint8_t[]>(message_size);
+    memset(message.get(), 0x5a, message_size);
+
+    std::atomic<size_t> connected{0};
+    std::atomic<size_t> completed{0};
+    std::vector<echo_client> clients(connections);
+    for (auto& client : clients) {
+        client.left = round_trips / connections;
+        client.tcp = looper::create_tcp(loop);
+        looper::connect_tcp(client.tcp, "127.0.0.1", port, [&connected](looper::tcp, const looper::error error) {
+            if (error == looper::error_success) {
+                connected++;
+            }
+        });
+    }
+    if (!wait_for([&]()->bool { return connected == connections && accepted_count == connections; })) {
+        printf("failed to connect\n");
+        return;
+    }
+
+    const auto before = looper::get_loop_stats(loop);
+    const stopwatch watch;
+    for (auto& client : clients) {
+        looper::start_tcp_read(client.tcp, [&client, &completed, message](const looper::tcp tcp, const std::span<const uint8_t> data, const looper::error error) {
+            if (error != looper::error_success) {
+                return;
+            }
+
+            client.received += data.size();
+            if (client.received < message_size) {
+                return;
+            }
+
+            client.received -= message_size;
+            completed++;
+            if (--client.left > 0) {
+                looper::write_tcp(tcp, message, message_size, [](looper::tcp, looper::error) {});
+            }
+        });
+        looper::write_tcp(client.tcp, message, message_size, [](looper::tcp, looper::error) {});
+    }
+
+    const auto expected = (round_trips / connections) * connections;
+    wait_for([&]()->bool { return completed == expected; }, std::chrono::seconds(60));
+
+    char name[64];
+    snprintf(name, sizeof(name), "echo: epoll%s", edge_triggered ? ", edge" : "");
+    report(name, completed, "trips", watch);
+
+    const auto after = looper::get_loop_stats(loop);
+    printf("    loop wakeups %lu, events %lu, poller updates %lu\n",
+           after.wakeups - before.wakeups,
+           after.events - before.events,
+           after.poller_updates - before.poller_updates);
+
+    // so closing one end is not reported as an error by the other
+    for (size_t i = 0; i < accepted_count; i++) {
+        looper::stop_tcp_read(accepted[i]);
+    }
+    for (auto& client : clients) {
+        looper::destroy_tcp(client.tcp);
+    }
+    for (size_t i = 0; i < accepted_count; i++) {
+        looper::destroy_tcp(accepted[i]);
+    }
+    looper::destroy_tcp_server(server);
+    looper::destroy(loop);
+}
+
+int main() {
+    constexpr size_t round_trips = 200000;
+
+    bench_echo(false, base_port, round_trips);
+    bench_echo(true, base_port + 1, round_trips);
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <malloc.h>
+#include <sys/resource.h>
+#include <vector>
+
+#include <looper.h>
+
+#include "bench.h"
+
+using namespace looper::bench;
+
+// descriptors kept free for the loop itself and the standard streams
+static constexpr size_t reserved_descriptors = 64;
+
+// each tcp handle takes a descriptor, so as many as the process may open are allowed
+static size_t raise_descriptor_limit() {
+    rlimit limit{};
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+
+    return limit.rlim_cur > reserved_descriptors ? limit.rlim_cur - reserved_descriptors : 0;
+}
+
+static size_t heap_in_use() {
+    return mallinfo2().uordblks;
+}
+
+// memory kept by the loop for each live tcp handle. this includes the handle table slots, which grow
+// in chunks as handles are added, along with the socket object and its loop resource.
+static void bench_tcp_handles(const size_t count, const size_t max_count) {
+    const auto live = std::min(count, max_count);
+    if (live < count) {
+        printf("%lu tcp handles limited to %lu by the descriptor limit\n", count, live);
+    }
+
+    const auto loop = looper::create();
+
+    std::vector<looper::tcp> tcps;
+    tcps.reserve(live);
+
+    const auto heap_before = heap_in_use();
+    {
+        const stopwatch watch;
+        for (size_t i = 0; i < live; i++) {
+            tcps.push_back(looper::create_tcp(loop));
+        }
+        report("tcp handles: create", live, "handles", watch);
+    }
+    const auto heap_after = heap_in_use();
+    printf("    %.1f bytes of memory per live handle\n",
+           static_cast<double>(heap_after - heap_before) / static_cast<double>(live));
+
+    {
+        const stopwatch watch;
+        for (const auto tcp : tcps) {
+            looper::destroy_tcp(tcp);
+        }
+        report("tcp handles: destroy", live, "handles", watch);
+    }
+
+    looper::destroy(loop);
+}
+
+// objects created and destroyed over and over, with some kept alive so released slots are scattered
+// through the table. allocating and releasing a slot should cost the same however the table is used.
+template<typename create_, typename destroy_>
+static void bench_churn(const char* name, const size_t count, const size_t live, create_&& create, destroy_&& destroy) {
+    const auto loop = looper::create();
+
+    std::vector<looper::handle> handles;
+    handles.reserve(live);
+    for (size_t i = 0; i < live; i++) {
+        handles.push_back(create(loop));
+    }
+
+    const stopwatch watch;
+    for (size_t i = 0; i < count; i++) {
+        auto& handle = handles[i % live];
+        destroy(handle);
+        handle = create(loop);
+    }
+    report(name, count, "handles", watch);
+
+    for (const auto handle : handles) {
+        destroy(handle);
+    }
+    looper::destroy(loop);
+}
+
+int main() {
+    const auto max_count = raise_descriptor_limit();
+
+    bench_tcp_handles(10000, max_count);
+    bench_tcp_handles(100000, max_count);
+
+    bench_churn("churn: tcp", 1000000, 1000,
+                [](const looper::loop loop)->looper::handle { return looper::create_tcp(loop); },
+                [](const looper::handle handle)->void { looper::destroy_tcp(handle); });
+    bench_churn("churn: timer", 1000000, 1000,
+                [](const looper::loop loop)->looper::handle { return looper::create_timer(loop, std::chrono::hours(1), [](looper::timer) {}); },
+                [](const looper::handle handle)->void { looper::destroy_timer(handle); });
+    return 0;
+}
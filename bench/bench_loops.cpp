@@ -0,0 +1,64 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <looper.h>
+
+#include "bench.h"
+
+using namespace std::chrono_literals;
+using namespace looper::bench;
+
+// independent loops, each used only by its own thread. every call resolves a handle of the thread's loop,
+// which should not contend with other loops, so total throughput should grow with the amount of loops
+// (up to the amount of cpus).
+static void bench_loops(const size_t loop_count, const size_t calls_per_loop) {
+    std::vector<looper::loop> loops;
+    loops.reserve(loop_count);
+    for (size_t i = 0; i < loop_count; i++) {
+        loops.push_back(looper::create());
+    }
+
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    threads.reserve(loop_count);
+    for (const auto loop : loops) {
+        threads.emplace_back([loop, calls_per_loop, &go]()->void {
+            const auto timer = looper::create_timer(loop, 1h, [](looper::timer) {});
+            while (!go) {
+                std::this_thread::yield();
+            }
+
+            for (size_t i = 0; i < calls_per_loop; i += 2) {
+                looper::start_timer(timer);
+                looper::stop_timer(timer);
+            }
+
+            looper::destroy_timer(timer);
+        });
+    }
+
+    const stopwatch watch;
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "loops: %lu loops", loop_count);
+    report(name, loop_count * calls_per_loop, "calls", watch);
+
+    for (const auto loop : loops) {
+        looper::destroy(loop);
+    }
+}
+
+int main() {
+    constexpr size_t calls_per_loop = 1000000;
+
+    for (const size_t loop_count : {1, 2, 4, 8, 16}) {
+        bench_loops(loop_count, calls_per_loop);
+    }
+    return 0;
+}
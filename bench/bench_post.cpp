@@ -0,0 +1,65 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <looper.h>
+
+#include "bench.h"
+
+using namespace looper::bench;
+
+// callbacks posted into one loop from many threads at once. posting takes no lock shared with the loop thread,
+// so the rate should hold up as producers are added, rather than collapse on contention.
+static void bench_producers(const size_t producers, const size_t posts_per_producer) {
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    std::atomic<size_t> executed{0};
+    std::atomic<bool> go{false};
+    const auto total = producers * posts_per_producer;
+
+    std::vector<std::thread> threads;
+    threads.reserve(producers);
+    for (size_t i = 0; i < producers; i++) {
+        threads.emplace_back([&]()->void {
+            while (!go) {
+                std::this_thread::yield();
+            }
+
+            for (size_t j = 0; j < posts_per_producer; j++) {
+                looper::post(loop, [&executed](looper::loop) {
+                    executed.fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+        });
+    }
+
+    const auto before = looper::get_loop_stats(loop);
+    const stopwatch watch;
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const auto post_seconds = watch.wall_seconds();
+    wait_for([&]()->bool { return executed == total; }, std::chrono::seconds(60));
+
+    char name[64];
+    snprintf(name, sizeof(name), "post: %lu producers", producers);
+    report(name, executed, "calls", watch);
+
+    const auto after = looper::get_loop_stats(loop);
+    printf("    %.0f ns per post, loop wakeups %lu\n",
+           post_seconds * 1e9 / static_cast<double>(total),
+           after.wakeups - before.wakeups);
+
+    looper::destroy(loop);
+}
+
+int main() {
+    constexpr size_t total = 1000000;
+
+    for (const size_t producers : {1, 2, 4, 8, 16, 32}) {
+        bench_producers(producers, total / producers);
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include <chrono>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <looper.h>
+
+#include "bench.h"
+
+using namespace std::chrono_literals;
+using namespace looper::bench;
+
+static constexpr uint16_t base_port = 47331;
+static constexpr size_t message_size = 64;
+
+static bool connect_client(const int fd, const uint16_t port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+}
+
+// many sockets becoming readable together. the loop is run from this thread only after every client sent,
+// so each round is a single burst of events. the amount of polls needed to take a burst shows how well the
+// event batch adapts to the amount of active sockets.
+static void bench_active_sockets(const size_t connections, const uint16_t port, const size_t rounds) {
+    const auto loop = looper::create();
+
+    size_t received = 0;
+    std::vector<looper::tcp> accepted;
+    accepted.reserve(connections);
+
+    const auto server = looper::create_tcp_server(loop);
+    looper::bind_tcp_server(server, "127.0.0.1", port);
+    looper::listen_tcp(server, connections, [&](const looper::tcp_server tcp_server) {
+        const auto tcp = looper::accept_tcp(tcp_server);
+        looper::start_tcp_read(tcp, [&received](looper::tcp, const std::span<const uint8_t> data, const looper::error error) {
+            if (error == looper::error_success) {
+                received += data.size();
+            }
+        });
+        accepted.push_back(tcp);
+    });
+
+    std::vector<int> clients;
+    clients.reserve(connections);
+    for (size_t i = 0; i < connections; i++) {
+        const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0 || !connect_client(fd, port)) {
+            printf("failed to connect %lu clients\n", connections);
+            if (fd >= 0) {
+                close(fd);
+            }
+            break;
+        }
+        clients.push_back(fd);
+
+        // take connections as they come, so the listen backlog does not fill up
+        if (i % 64 == 63 || i == connections - 1) {
+            while (accepted.size() < clients.size()) {
+                looper::run_once(loop);
+            }
+        }
+    }
+
+    uint8_t message[message_size]{};
+    const auto before = looper::get_loop_stats(loop);
+    const stopwatch watch;
+    for (size_t round = 0; round < rounds; round++) {
+        for (const auto fd : clients) {
+            (void) send(fd, message, sizeof(message), 0);
+        }
+
+        const auto expected = (round + 1) * clients.size() * message_size;
+        while (received < expected) {
+            looper::run_once(loop);
+        }
+    }
+    const auto after = looper::get_loop_stats(loop);
+
+    char name[64];
+    snprintf(name, sizeof(name), "active sockets: %lu", clients.size());
+    report(name, after.events - before.events, "events", watch);
+
+    const auto polls = after.wakeups - before.wakeups;
+    const auto events = after.events - before.events;
+    printf("    %lu polls, %.1f events per poll, %lu full batches, %.2f polls per burst\n",
+           polls,
+           static_cast<double>(events) / static_cast<double>(polls),
+           after.full_event_batches - before.full_event_batches,
+           static_cast<double>(polls) / static_cast<double>(rounds));
+
+    // so closing the clients is not reported as an error
+    for (const auto tcp : accepted) {
+        looper::stop_tcp_read(tcp);
+    }
+    for (const auto fd : clients) {
+        close(fd);
+    }
+    for (const auto tcp : accepted) {
+        looper::destroy_tcp(tcp);
+    }
+    looper::destroy_tcp_server(server);
+    looper::destroy(loop);
+}
+
+int main() {
+    bench_active_sockets(100, base_port, 1000);
+    bench_active_sockets(1000, base_port + 1, 200);
+    bench_active_sockets(5000, base_port + 2, 50);
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <looper.h>
+
+#include "bench.h"
+
+using namespace looper::bench;
+
+static constexpr uint16_t base_port = 47341;
+
+// a bulk transfer into a tcp socket of the loop, sent by a plain socket from another thread.
+// each read callback gets at most the loop's read buffer size, so a larger buffer means fewer reads
+// and callbacks for the same data.
+static void bench_bulk_read(const size_t read_buffer_size, const bool edge_triggered, const uint16_t port, const size_t total) {
+    looper::loop_options options{};
+    options.read_buffer_size = read_buffer_size;
+    options.edge_triggered_io = edge_triggered;
+    const auto loop = looper::create(options);
+    looper::exec_in_thread(loop);
+
+    std::atomic<size_t> received{0};
+    std::atomic<size_t> reads{0};
+    std::atomic<looper::tcp> accepted{looper::empty_handle};
+
+    const auto server = looper::create_tcp_server(loop);
+    looper::bind_tcp_server(server, "127.0.0.1", port);
+    looper::listen_tcp(server, 1, [&](const looper::tcp_server tcp_server) {
+        const auto tcp = looper::accept_tcp(tcp_server);
+        looper::start_tcp_read(tcp, [&](looper::tcp, const std::span<const uint8_t> data, const looper::error error) {
+            if (error == looper::error_success) {
+                received.fetch_add(data.size(), std::memory_order_relaxed);
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        accepted = tcp;
+    });
+
+    const auto client = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (client < 0 || connect(client, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        !wait_for([&]()->bool { return accepted != looper::empty_handle; })) {
+        printf("failed to connect\n");
+        return;
+    }
+
+    const auto before = looper::get_loop_stats(loop);
+    const stopwatch watch;
+    std::thread sender([client, total]()->void {
+        const std::vector<uint8_t> chunk(1024 * 1024, 0x5a);
+        size_t sent = 0;
+        while (sent < total) {
+            const auto result = send(client, chunk.data(), std::min(chunk.size(), total - sent), 0);
+            if (result <= 0) {
+                break;
+            }
+            sent += result;
+        }
+    });
+    wait_for([&]()->bool { return received == total; }, std::chrono::seconds(60));
+    sender.join();
+
+    char name[64];
+    snprintf(name, sizeof(name), "bulk read: %luKB buffer%s", read_buffer_size / 1024, edge_triggered ? ", edge" : "");
+    report(name, reads, "reads", watch);
+
+    const auto after = looper::get_loop_stats(loop);
+    printf("    %.1f MB/s, %.0f bytes per read, loop wakeups %lu\n",
+           static_cast<double>(received) / watch.wall_seconds() / (1024 * 1024),
+           static_cast<double>(received) / static_cast<double>(reads),
+           after.wakeups - before.wakeups);
+
+    looper::stop_tcp_read(accepted);
+    close(client);
+    looper::destroy_tcp(accepted);
+    looper::destroy_tcp_server(server);
+    looper::destroy(loop);
+}
+
+int main() {
+    constexpr size_t total = 1024ul * 1024 * 1024;
+
+    bench_bulk_read(4 * 1024, false, base_port, total);
+    bench_bulk_read(64 * 1024, false, base_port + 1, total);
+    bench_bulk_read(4 * 1024, true, base_port + 2, total);
+    bench_bulk_read(64 * 1024, true, base_port + 3, total);
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+#include <looper.h>
+
+#include "bench.h"
+
+using namespace looper::bench;
+
+static constexpr uint16_t port = 47301;
+
+// many small writes queued on a tcp socket faster than it drains. queued writes are sent
+// together with one call to the os, so the cost per write should stay low even for tiny writes.
+static void bench_writes(const looper::loop loop, const looper::tcp client, const size_t write_size, const size_t count,
+                         std::atomic<size_t>& received) {
+    auto buffer = std::make_shared_for_overwrite<uint8_t[]>(write_size);
+    memset(buffer.get(), 0x5a, write_size);
+
+    std::atomic<size_t> completed{0};
+    const auto start_received = received.load();
+    const auto before = looper::get_loop_stats(loop);
+
+    const stopwatch watch;
+    for (size_t i = 0; i < count; i++) {
+        looper::write_tcp(client, buffer, write_size, [&completed](looper::handle, looper::error) {
+            completed++;
+        });
+    }
+    wait_for([&]()->bool { return completed == count && received - start_received == count * write_size; });
+
+    char name[64];
+    snprintf(name, sizeof(name), "tcp writes: %lu bytes", write_size);
+    report(name, completed, "writes", watch);
+
+    const auto after = looper::get_loop_stats(loop);
+    printf("    %.1f MB/s, loop wakeups %lu\n",
+           static_cast<double>(received - start_received) / watch.wall_seconds() / (1024 * 1024),
+           after.wakeups - before.wakeups);
+}
+
+int main() {
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    std::atomic<size_t> received{0};
+    std::atomic<looper::tcp> accepted{looper::empty_handle};
+
+    const auto server = looper::create_tcp_server(loop);
+    looper::bind_tcp_server(server, "127.0.0.1", port);
+    looper::listen_tcp(server, 1, [&](const looper::tcp_server tcp_server) {
+        const auto tcp = looper::accept_tcp(tcp_server);
+        looper::start_tcp_read(tcp, [&received](looper::handle, const std::span<const uint8_t> data, const looper::error error) {
+            if (error == looper::error_success) {
+                received += data.size();
+            }
+        });
+        accepted = tcp;
+    });
+
+    std::atomic<bool> connected{false};
+    const auto client = looper::create_tcp(loop);
+    looper::connect_tcp(client, "127.0.0.1", port, [&connected](looper::handle, const looper::error error) {
+        connected = error == looper::error_success;
+    });
+    if (!wait_for([&]()->bool { return connected && accepted != looper::empty_handle; })) {
+        printf("failed to connect\n");
+        return 1;
+    }
+
+    bench_writes(loop, client, 64, 500000, received);
+    bench_writes(loop, client, 512, 200000, received);
+    bench_writes(loop, client, 4096, 50000, received);
+
+    looper::destroy_tcp(client);
+    looper::destroy_tcp(accepted);
+    looper::destroy_tcp_server(server);
+    looper::destroy(loop);
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include <looper.h>
+
+#include "bench.h"
+
+using namespace std::chrono_literals;
+using namespace looper::bench;
+
+// scheduling cost of many pending timers, which are kept in a heap by the loop
+static void bench_schedule(const size_t count) {
+    const auto loop = looper::create();
+
+    std::mt19937 random(count);
+    std::uniform_int_distribution<int> timeouts(1000, 60000);
+
+    std::vector<looper::timer> timers;
+    timers.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        timers.push_back(looper::create_timer(loop, std::chrono::milliseconds(timeouts(random)), [](looper::timer) {}));
+    }
+
+    {
+        const stopwatch watch;
+        for (const auto timer : timers) {
+            looper::start_timer(timer);
+        }
+        report("timers: start", count, "timers", watch);
+    }
+    {
+        const stopwatch watch;
+        for (const auto timer : timers) {
+            looper::reset_timer(timer);
+        }
+        report("timers: reset", count, "timers", watch);
+    }
+    {
+        const stopwatch watch;
+        for (const auto timer : timers) {
+            looper::stop_timer(timer);
+        }
+        report("timers: stop", count, "timers", watch);
+    }
+
+    looper::destroy(loop);
+}
+
+// firing many timers spread over a short time, with and without slack to coalesce them
+static void bench_fire(const size_t count, const std::chrono::milliseconds slack) {
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    std::atomic<size_t> hits{0};
+    std::vector<looper::timer> timers;
+    timers.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const auto timeout = 50ms + std::chrono::microseconds(i * 100000 / count);
+        timers.push_back(looper::create_timer(loop, timeout, [&hits](looper::timer) {
+            hits++;
+        }, looper::timer_mode::oneshot, slack));
+    }
+
+    const auto before = looper::get_loop_stats(loop);
+    const stopwatch watch;
+    for (const auto timer : timers) {
+        looper::start_timer(timer);
+    }
+    wait_for([&]()->bool { return hits == count; });
+
+    char name[64];
+    snprintf(name, sizeof(name), "timers: fire, slack %ldms", static_cast<long>(slack.count()));
+    report(name, hits, "timers", watch);
+
+    const auto after = looper::get_loop_stats(loop);
+    printf("    timer wakeups %lu, coalesced %lu\n",
+           after.timer_wakeups - before.timer_wakeups,
+           after.coalesced_timer_wakeups - before.coalesced_timer_wakeups);
+
+    looper::destroy(loop);
+}
+
+// cost of a loop iteration while many timers are armed. timers not yet due should not add to it.
+static void bench_run_once(const size_t count) {
+    constexpr size_t iterations = 100000;
+
+    const auto loop = looper::create();
+
+    std::vector<looper::timer> timers;
+    timers.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        timers.push_back(looper::create_timer(loop, 1h + std::chrono::microseconds(i), [](looper::timer) {}));
+        looper::start_timer(timers.back());
+    }
+
+    // each iteration is woken by a queued callback, so none waits on the os
+    const stopwatch watch;
+    for (size_t i = 0; i < iterations; i++) {
+        looper::execute_later(loop, [](looper::loop) {});
+        looper::run_once(loop);
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "timers: run_once, %lu armed", count);
+    report(name, iterations, "runs", watch);
+    printf("    %.0f ns per run\n", watch.wall_seconds() * 1e9 / iterations);
+
+    looper::destroy(loop);
+}
+
+// cost of each expiry when many timers are due together
+static void bench_expire(const size_t count) {
+    const auto loop = looper::create();
+
+    size_t hits = 0;
+    std::vector<looper::timer> timers;
+    timers.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        timers.push_back(looper::create_timer(loop, 1ms + std::chrono::microseconds(i % 1000), [&hits](looper::timer) {
+            hits++;
+        }));
+        looper::start_timer(timers.back());
+    }
+    std::this_thread::sleep_for(10ms);
+
+    size_t runs = 0;
+    const stopwatch watch;
+    while (hits < count) {
+        looper::run_once(loop);
+        runs++;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "timers: expire, %lu armed", count);
+    report(name, hits, "timers", watch);
+    printf("    %.0f ns per expiry, %.0f ns per run, %lu runs\n",
+           watch.wall_seconds() * 1e9 / static_cast<double>(hits), watch.wall_seconds() * 1e9 / static_cast<double>(runs), runs);
+
+    looper::destroy(loop);
+}
+
+// how late timers fire past their requested deadline. the timer is reset from its own callback,
+// so the requested deadline is known exactly.
+static void bench_jitter(const std::chrono::microseconds timeout, const size_t samples) {
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    std::vector<int64_t> lateness;
+    lateness.reserve(samples);
+    std::atomic<bool> done{false};
+    std::chrono::steady_clock::time_point deadline;
+
+    const auto timer = looper::create_timer(loop, timeout, [&](const looper::timer timer) {
+        const auto now = std::chrono::steady_clock::now();
+        lateness.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline).count());
+        if (lateness.size() == samples) {
+            done = true;
+            return;
+        }
+
+        deadline = std::chrono::steady_clock::now() + timeout;
+        looper::reset_timer(timer);
+    });
+    looper::execute_later(loop, [&](looper::loop) {
+        deadline = std::chrono::steady_clock::now() + timeout;
+        looper::start_timer(timer);
+    });
+
+    // sleeping rather than spinning while waiting, so the loop thread has the cpu to itself
+    const stopwatch watch;
+    while (!done) {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    std::sort(lateness.begin(), lateness.end());
+    const auto percentile = [&lateness](const double p)->double {
+        return static_cast<double>(lateness[static_cast<size_t>(p * static_cast<double>(lateness.size() - 1))]) / 1000;
+    };
+
+    char name[64];
+    snprintf(name, sizeof(name), "timers: jitter, %ldus", static_cast<long>(timeout.count()));
+    report(name, lateness.size(), "timers", watch);
+    printf("    late by p50 %.1fus, p99 %.1fus, max %.1fus\n", percentile(0.5), percentile(0.99), percentile(1));
+
+    looper::destroy(loop);
+}
+
+int main() {
+    bench_schedule(100000);
+    bench_schedule(500000);
+    bench_fire(10000, 0ms);
+    bench_fire(10000, 10ms);
+    bench_run_once(0);
+    bench_run_once(100000);
+    bench_expire(100000);
+    bench_jitter(100us, 5000);
+    bench_jitter(250us, 4000);
+    bench_jitter(500us, 2000);
+    bench_jitter(1000us, 1000);
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include <looper.h>
+
+#include "bench.h"
+
+using namespace looper::bench;
+
+static constexpr uint16_t receive_port = 47311;
+static constexpr uint16_t send_port = 47312;
+static constexpr size_t datagram_size = 64;
+
+enum class udp_mode {
+    single,
+    batch,
+    // coalesced by the os (UDP GRO and GSO)
+    segmented
+};
+
+static const char* mode_name(const udp_mode mode) {
+    switch (mode) {
+        case udp_mode::single:
+            return "single";
+        case udp_mode::batch:
+            return "batch";
+        case udp_mode::segmented:
+            return "segmented";
+    }
+
+    return "";
+}
+
+// datagrams sent by another socket of the loop, received one per call to the os, in batches,
+// or coalesced by the os into fewer reads
+static void bench_receive(const udp_mode mode, const size_t count) {
+    const auto loop = looper::create();
+    const auto receiver = looper::create_udp(loop);
+    const auto sender = looper::create_udp(loop);
+    looper::bind_udp(receiver, receive_port);
+
+    std::atomic<size_t> received{0};
+    std::atomic<size_t> callbacks{0};
+    if (mode == udp_mode::batch) {
+        looper::start_udp_read_batch(receiver, [&](looper::udp, const std::span<const looper::udp_datagram> datagrams, looper::error) {
+            received += datagrams.size();
+            callbacks++;
+        });
+    } else if (mode == udp_mode::segmented) {
+        try {
+            looper::start_udp_read_segmented(receiver, [&](looper::udp, looper::inet_endpoint, const std::span<const uint8_t> data,
+                                                           const size_t segment_size, const looper::error error) {
+                if (error == looper::error_success && segment_size > 0) {
+                    received += (data.size() + segment_size - 1) / segment_size;
+                }
+                callbacks++;
+            });
+        } catch (const looper::os_exception& e) {
+            printf("udp receive: segmented not supported: code=%lu\n", static_cast<unsigned long>(e.get_code()));
+            looper::destroy(loop);
+            return;
+        }
+    } else {
+        looper::start_udp_read_endpoint(receiver, [&](looper::udp, looper::inet_endpoint, std::span<const uint8_t>, const looper::error error) {
+            if (error == looper::error_success) {
+                received++;
+            }
+            callbacks++;
+        });
+    }
+    looper::exec_in_thread(loop);
+
+    const auto destination = looper::make_inet_endpoint({"127.0.0.1", receive_port});
+    // the os only keeps datagrams coalesced when they are sent coalesced, so for segmented reads
+    // they are sent by segmented writes
+    const size_t datagrams_per_write = mode == udp_mode::segmented ? 64 : 1;
+    std::vector<uint8_t> payload(datagram_size * datagrams_per_write, 0x5a);
+
+    // datagrams in flight are limited so the socket buffer of the receiver does not overflow.
+    // if some are still lost, they are given up on after a while.
+    constexpr size_t window = 128;
+    size_t lost = 0;
+
+    std::atomic<bool> unsupported{false};
+    const stopwatch watch;
+    for (size_t i = 0; i < count && !unsupported; i += datagrams_per_write) {
+        if (mode == udp_mode::segmented) {
+            looper::write_udp_segmented(sender, destination, payload, datagram_size, [&unsupported](looper::udp, const looper::error error) {
+                if (error == looper::error_operation_not_supported) {
+                    unsupported = true;
+                }
+            });
+        } else {
+            looper::write_udp(sender, destination, payload, [](looper::udp, looper::error) {});
+        }
+        if (!wait_for([&]()->bool { return i < received + lost + window || unsupported; }, std::chrono::milliseconds(50))) {
+            lost = i - received;
+        }
+    }
+    wait_for([&]()->bool { return received + lost >= count; }, std::chrono::milliseconds(200));
+    if (unsupported) {
+        printf("udp receive: %s not supported\n", mode_name(mode));
+        looper::destroy(loop);
+        return;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "udp receive: %s", mode_name(mode));
+    report(name, received, "datagrams", watch);
+    printf("    read callbacks %lu, lost %lu\n", callbacks.load(), count - received);
+
+    looper::destroy(loop);
+}
+
+// datagrams written one by one, together so queued ones are sent with one call to the os,
+// or as one buffer split into datagrams by the os
+static void bench_send(const udp_mode mode, const size_t count) {
+    constexpr size_t batch_size = 256;
+    constexpr size_t segments = 64;
+
+    const auto loop = looper::create();
+    const auto receiver = looper::create_udp(loop);
+    const auto sender = looper::create_udp(loop);
+    looper::bind_udp(receiver, send_port);
+    looper::start_udp_read_batch(receiver, [](looper::udp, std::span<const looper::udp_datagram>, looper::error) {});
+    looper::exec_in_thread(loop);
+
+    std::vector<uint8_t> payload(datagram_size, 0x5a);
+    std::vector<uint8_t> segmented_payload(datagram_size * segments, 0x5a);
+    const auto destination = looper::make_inet_endpoint({"127.0.0.1", send_port});
+    std::vector<looper::udp_message> messages;
+    for (size_t i = 0; i < batch_size; i++) {
+        messages.push_back(looper::udp_message{destination, payload});
+    }
+
+    // counted in datagrams, a segmented write completes all of its datagrams together
+    std::atomic<size_t> completed{0};
+    std::atomic<looper::error> error{looper::error_success};
+    const auto on_written = [&completed, &error](looper::udp, const looper::error write_error) {
+        if (write_error != looper::error_success) {
+            error = write_error;
+        }
+        completed++;
+    };
+    const auto on_segmented_written = [&completed, &error](looper::udp, const looper::error write_error) {
+        if (write_error != looper::error_success) {
+            error = write_error;
+        }
+        completed += segments;
+    };
+
+    const stopwatch watch;
+    for (size_t i = 0; i < count && error == looper::error_success; i += batch_size) {
+        switch (mode) {
+            case udp_mode::single:
+                for (size_t j = 0; j < batch_size; j++) {
+                    looper::write_udp(sender, destination, payload, on_written);
+                }
+                break;
+            case udp_mode::batch:
+                looper::write_udp_batch(sender, messages, on_written);
+                break;
+            case udp_mode::segmented:
+                for (size_t j = 0; j < batch_size; j += segments) {
+                    looper::write_udp_segmented(sender, destination, segmented_payload, datagram_size, on_segmented_written);
+                }
+                break;
+        }
+        wait_for([&]()->bool { return completed == i + batch_size; });
+    }
+
+    if (error == looper::error_operation_not_supported) {
+        printf("udp send: %s not supported\n", mode_name(mode));
+    } else {
+        char name[64];
+        snprintf(name, sizeof(name), "udp send: %s", mode_name(mode));
+        report(name, completed, "datagrams", watch);
+    }
+
+    looper::destroy(loop);
+}
+
+int main() {
+    bench_receive(udp_mode::single, 200000);
+    bench_receive(udp_mode::batch, 200000);
+    bench_receive(udp_mode::segmented, 199936);
+    bench_send(udp_mode::single, 200192);
+    bench_send(udp_mode::batch, 200192);
+    bench_send(udp_mode::segmented, 200192);
+
+    return 0;
+}
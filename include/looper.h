@@ -1,6 +1,8 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
+#include <vector>
 
 #include <looper_types.h>
 #include <looper_except.h>
@@ -14,9 +16,10 @@ namespace looper {
  * Creates a new loop. Each loop exists individually and manages its own objects and resources.
  * The loop is created empty.
  *
+ * @param options options for the loop's behaviour
  * @return loop handle
  */
-loop create();
+loop create(const loop_options& options = {});
 
 /**
  * Destroys a given loop. Any attached objects are destroyed as well. Any run calls will result in exceptions.
@@ -66,6 +69,15 @@ void run_forever(loop loop);
  */
 void exec_in_thread(loop loop);
 
+/**
+ * Queries the run statistics of the loop. Statistics are counted from the creation of the loop.
+ * Can be used to verify loop behaviour, for example that an idle loop is not woken up needlessly.
+ *
+ * @param loop loop handle
+ * @return statistics of the loop
+ */
+loop_stats get_loop_stats(loop loop);
+
 /**
  * Create a new future object and attaches it to the given loop. A future provides a timed execution of
  * a callback. When can schedule the callback to execute after some time. This can be done multiple times
@@ -108,26 +120,45 @@ void execute_once(future future, std::chrono::milliseconds delay = no_timeout);
 bool wait_for(future future, std::chrono::milliseconds timeout = no_timeout);
 
 /**
- * Creates a future inplace with the given callback and executes it. The future will be destroyed
- * afterward.
+ * Queues the given callback for execution on the loop as soon as possible. Equivalent to post.
  *
  * @param loop loop handle
- * @param callback execution callback for future
+ * @param callback callback to execute
  */
 void execute_later(loop loop, loop_callback&& callback);
 
 /**
- * Creates a future inplace with the given callback and executes it. This function will wait until
- * the future finishes execution before returning. The future will be destroyed afterward.
- *
+ * Queues the given callback for execution on the loop as soon as possible, like post, and waits until it
+ * was executed. Must not be called from the loop's own thread, as the loop cannot run while waiting.
+ * If the wait times out, the callback is still executed later.
  *
  * @param loop loop handle
- * @param callback execution callback for future
- * @param timeout timeout for waiting for the future to execute, or 0 for no timeout.
+ * @param callback callback to execute
+ * @param timeout timeout for waiting for the callback to execute, or 0 for no timeout.
  * @return false if executed, or true if timed out.
  */
 bool execute_later_and_wait(loop loop, loop_callback&& callback, std::chrono::milliseconds timeout = no_timeout);
 
+/**
+ * Queues the given callback for execution on the loop as soon as possible.
+ * Unlike futures, posted callbacks require no handle, so there is no limit on the amount of callbacks queued.
+ * Callbacks posted to a loop execute in the order they were posted.
+ *
+ * @param loop loop handle
+ * @param callback callback to execute
+ */
+void post(loop loop, loop_callback&& callback);
+
+/**
+ * Queues the given callback for execution on the loop once the given deadline passes.
+ * Like post, this requires no handle. Callbacks with the same deadline execute in the order they were posted.
+ *
+ * @param loop loop handle
+ * @param deadline time point after which to execute the callback
+ * @param callback callback to execute
+ */
+void post_at(loop loop, std::chrono::steady_clock::time_point deadline, loop_callback&& callback);
+
 /**
  * Creates a new event object and attaches it to the given loop. An event can be set or cleared.
  * When set, the callback will execute. Clearing the event is necessary before setting it again or nothing
@@ -167,13 +198,20 @@ void clear_event(event event);
  * Creates a new timer object and attaches it to the given loop. A timer counts time from its start
  * and will execute its callback upon reaching timeout if not stopped prior.
  * The timer objects is created as stopped and reset.
+ * A periodic timer re-arms itself on each timeout without requiring calls to reset_timer, keeping its
+ * schedule relative to the previous deadline rather than to when the callback ran.
+ * A timer may be given slack, allowing it to fire up to that much later than its timeout. The loop uses
+ * this to fire timers with close timeouts in a single wakeup, which is useful for large amounts of idle timeouts.
  *
  * @param loop loop handle
- * @param timeout timeout for timer
+ * @param timeout timeout for timer, with up to nanosecond resolution
  * @param callback callback to execute on timeout
+ * @param mode whether the timer fires once or periodically, and how missed periods are handled
+ * @param slack how late past its timeout the timer may fire. negative slack is rejected.
  * @return timer handle.
  */
-timer create_timer(loop loop, std::chrono::milliseconds timeout, timer_callback&& callback);
+timer create_timer(loop loop, std::chrono::nanoseconds timeout, timer_callback&& callback,
+                   timer_mode mode = timer_mode::oneshot, std::chrono::nanoseconds slack = no_slack);
 
 /**
  * Destroys the given timer, making it unusable.
@@ -262,6 +300,19 @@ void connect_tcp(tcp tcp, std::string_view address, uint16_t port, connect_callb
  */
 void start_tcp_read(tcp tcp, read_callback&& callback);
 
+/**
+ * Starts automatic reading from the client into buffers given by the caller. Before each read, the provider is
+ * called for the buffer to read into, and the read callback receives the part of that buffer which was filled.
+ * As the caller owns the buffers, read data may be kept after the callback without copying it.
+ * A buffer given by the provider is always read into before the provider is called again.
+ * See the other overload for more documentation.
+ *
+ * @param tcp tcp handle
+ * @param provider called for the buffer to read into
+ * @param callback callback called on read or error
+ */
+void start_tcp_read(tcp tcp, read_buffer_provider&& provider, read_callback&& callback);
+
 /**
  * Stops automatic reading of the tcp client. If not reading, nothing occurs.
  *
@@ -279,6 +330,41 @@ void stop_tcp_read(tcp tcp);
  */
 void write_tcp(tcp tcp, std::span<const uint8_t> buffer, write_callback&& callback);
 
+/**
+ * Writes data over the tcp client, taking ownership of the buffer instead of copying it.
+ * The buffer is released once the write is finished.
+ * See the span overload for more documentation.
+ *
+ * @param tcp tcp handle
+ * @param buffer data buffer to write
+ * @param size size of the data in the buffer
+ * @param callback callback for write result
+ */
+void write_tcp(tcp tcp, std::unique_ptr<uint8_t[]>&& buffer, size_t size, write_callback&& callback);
+
+/**
+ * Writes data over the tcp client, taking ownership of the buffer instead of copying it.
+ * The buffer is released once the write is finished.
+ * See the span overload for more documentation.
+ *
+ * @param tcp tcp handle
+ * @param buffer data buffer to write
+ * @param callback callback for write result
+ */
+void write_tcp(tcp tcp, std::vector<uint8_t>&& buffer, write_callback&& callback);
+
+/**
+ * Writes data over the tcp client, from a buffer shared with the caller. The library holds a reference
+ * to the buffer until the write is finished, and the data must not be modified until then.
+ * See the span overload for more documentation.
+ *
+ * @param tcp tcp handle
+ * @param buffer data buffer to write
+ * @param size size of the data in the buffer
+ * @param callback callback for write result
+ */
+void write_tcp(tcp tcp, shared_buffer buffer, size_t size, write_callback&& callback);
+
 /**
  * Creates a new tcp server object and attaches it to the given loop. This provides a tcp server.
  * At the time of creation, the socket is neither connected nor bound.
@@ -332,6 +418,23 @@ void listen_tcp(tcp_server tcp, size_t backlog, listen_callback&& callback);
  */
 tcp accept_tcp(tcp_server tcp);
 
+/**
+ * Resolves an IPv4 address into an endpoint. The endpoint can then be used for any number of
+ * writes without the ip being parsed again. If the ip is not a valid IPv4 address, an exception is thrown.
+ *
+ * @param address IPv4 IP and Port
+ * @return endpoint of the address
+ */
+inet_endpoint make_inet_endpoint(inet_address_view address);
+
+/**
+ * Formats an endpoint back into an address.
+ *
+ * @param endpoint endpoint to format
+ * @return address of the endpoint
+ */
+inet_address to_inet_address(inet_endpoint endpoint);
+
 /**
  * Creates a new udp object and attaches it to the given loop.
  * At the time of creation, the socket is not bound.
@@ -367,6 +470,66 @@ void bind_udp(udp udp, uint16_t port);
  */
 void start_udp_read(udp udp, udp_read_callback&& callback);
 
+/**
+ * Starts automatic reading from the socket into buffers given by the caller. Before each read, the provider is
+ * called for the buffer to read into, and the read callback receives the part of that buffer which was filled.
+ * See the other overload for more documentation.
+ *
+ * @param udp udp handle
+ * @param provider called for the buffer to read into
+ * @param callback callback called on read or error
+ */
+void start_udp_read(udp udp, read_buffer_provider&& provider, udp_read_callback&& callback);
+
+/**
+ * Starts automatic reading from the socket, giving the sender of each datagram as an endpoint.
+ * Unlike start_udp_read, the sender's ip is not formatted for each datagram.
+ * See start_udp_read for more documentation.
+ *
+ * @param udp udp handle
+ * @param callback callback called on read or error
+ */
+void start_udp_read_endpoint(udp udp, udp_endpoint_read_callback&& callback);
+
+/**
+ * Starts automatic reading from the socket into buffers given by the caller, giving the sender of each
+ * datagram as an endpoint. See start_udp_read for more documentation.
+ *
+ * @param udp udp handle
+ * @param provider called for the buffer to read into
+ * @param callback callback called on read or error
+ */
+void start_udp_read_endpoint(udp udp, read_buffer_provider&& provider, udp_endpoint_read_callback&& callback);
+
+/**
+ * Starts automatic reading from the socket, receiving several datagrams with each call to the os.
+ * The callback is invoked with all the datagrams received together, instead of once per datagram.
+ * Space for the batch is allocated once by this call. Datagrams larger than max_datagram_size are truncated.
+ * The sender of each datagram is given as an endpoint, see to_inet_address.
+ * See start_udp_read for more documentation.
+ *
+ * @param udp udp handle
+ * @param callback callback called on read or error
+ * @param batch_size the most datagrams received together
+ * @param max_datagram_size size of the space for each datagram
+ */
+void start_udp_read_batch(udp udp, udp_batch_read_callback&& callback, size_t batch_size = 64, size_t max_datagram_size = 2048);
+
+/**
+ * Starts automatic reading from the socket, letting the os coalesce datagrams of the same sender
+ * into a single read (UDP GRO). Each read is given to the callback with the size of the datagrams in it,
+ * every one of which has that size, except the last which may be shorter. The sender is given as an endpoint.
+ * If not supported by the os, error_operation_not_supported is thrown.
+ * Space for reads is allocated once by this call. A read which does not fit in it is dropped, along with all
+ * the datagrams in it.
+ * See start_udp_read for more documentation.
+ *
+ * @param udp udp handle
+ * @param callback callback called on read or error
+ * @param max_read_size size of the space for each read, at most 65536
+ */
+void start_udp_read_segmented(udp udp, udp_segmented_read_callback&& callback, size_t max_read_size = 65536);
+
 /**
  * Stops automatic reading of the socket. If not reading, nothing occurs.
  *
@@ -385,14 +548,137 @@ void stop_udp_read(udp udp);
  */
 void write_udp(udp udp, inet_address_view destination, std::span<const uint8_t> buffer, udp_callback&& callback);
 
+/**
+ * Writes data over the udp, taking ownership of the buffer instead of copying it.
+ * The buffer is released once the write is finished.
+ * See the span overload for more documentation.
+ *
+ * @param udp udp handle
+ * @param destination destination IPv4 IP and Port
+ * @param buffer data to write
+ * @param size size of the data in the buffer
+ * @param callback callback on write finished
+ */
+void write_udp(udp udp, inet_address_view destination, std::unique_ptr<uint8_t[]>&& buffer, size_t size, udp_callback&& callback);
+
+/**
+ * Writes data over the udp, taking ownership of the buffer instead of copying it.
+ * The buffer is released once the write is finished.
+ * See the span overload for more documentation.
+ *
+ * @param udp udp handle
+ * @param destination destination IPv4 IP and Port
+ * @param buffer data to write
+ * @param callback callback on write finished
+ */
+void write_udp(udp udp, inet_address_view destination, std::vector<uint8_t>&& buffer, udp_callback&& callback);
+
+/**
+ * Writes data over the udp, from a buffer shared with the caller. The library holds a reference
+ * to the buffer until the write is finished, and the data must not be modified until then.
+ * See the span overload for more documentation.
+ *
+ * @param udp udp handle
+ * @param destination destination IPv4 IP and Port
+ * @param buffer data to write
+ * @param size size of the data in the buffer
+ * @param callback callback on write finished
+ */
+void write_udp(udp udp, inet_address_view destination, shared_buffer buffer, size_t size, udp_callback&& callback);
+
+/**
+ * Writes data over the udp to an endpoint resolved in advance, avoiding parsing the destination's ip
+ * for each write. There is an overload taking an endpoint for each of the ways of passing the data.
+ * See the overloads taking an address for more documentation.
+ *
+ * @param udp udp handle
+ * @param destination destination endpoint, see make_inet_endpoint
+ * @param buffer data to write
+ * @param callback callback on write finished
+ */
+void write_udp(udp udp, inet_endpoint destination, std::span<const uint8_t> buffer, udp_callback&& callback);
+void write_udp(udp udp, inet_endpoint destination, std::unique_ptr<uint8_t[]>&& buffer, size_t size, udp_callback&& callback);
+void write_udp(udp udp, inet_endpoint destination, std::vector<uint8_t>&& buffer, udp_callback&& callback);
+void write_udp(udp udp, inet_endpoint destination, shared_buffer buffer, size_t size, udp_callback&& callback);
+
+/**
+ * Writes several datagrams over the udp with one call. The data of all the messages is copied, so
+ * it need not outlive the call. Queued datagrams are sent together, several with each call to the os.
+ * The callback is called once for each message, in the order of the messages.
+ * See write_udp for more documentation.
+ *
+ * @param udp udp handle
+ * @param messages datagrams to send and their destination endpoints, see make_inet_endpoint
+ * @param callback callback called for each message when its write is finished or an error occurs
+ */
+void write_udp_batch(udp udp, std::span<const udp_message> messages, udp_callback&& callback);
+
+/**
+ * Writes several datagrams over the udp with one call, to destinations given as addresses.
+ * Each address is resolved once, before writing. For destinations used repeatedly, prefer resolving
+ * them in advance with make_inet_endpoint and passing udp_message.
+ * See the udp_message overload for more documentation.
+ *
+ * @param udp udp handle
+ * @param messages datagrams to send and their destination IPv4 IPs and Ports
+ * @param callback callback called for each message when its write is finished or an error occurs
+ */
+void write_udp_batch(udp udp, std::span<const udp_address_message> messages, udp_callback&& callback);
+
+/**
+ * Writes data over the udp as several datagrams of segment_size each, the last of which may be
+ * shorter. The os splits the buffer (UDP GSO), so all the datagrams are sent with one call. If
+ * segment_size is 0 or not smaller than the buffer, a single datagram is sent.
+ * The os limits a segmented write to 64 datagrams and 65507 bytes in total, and each datagram to 65535
+ * bytes. Writes outside these limits are rejected with error_invalid_argument.
+ * See write_udp for more documentation.
+ *
+ * @param udp udp handle
+ * @param destination destination IPv4 IP and Port
+ * @param buffer data to write
+ * @param segment_size size of each datagram
+ * @param callback callback on write finished
+ */
+void write_udp_segmented(udp udp, inet_address_view destination, std::span<const uint8_t> buffer, size_t segment_size, udp_callback&& callback);
+
+/**
+ * Writes data over the udp as several datagrams, from a buffer shared with the caller.
+ * See the span overload and the shared buffer overload of write_udp for more documentation.
+ *
+ * @param udp udp handle
+ * @param destination destination IPv4 IP and Port
+ * @param buffer data to write
+ * @param size size of the data in the buffer
+ * @param segment_size size of each datagram
+ * @param callback callback on write finished
+ */
+void write_udp_segmented(udp udp, inet_address_view destination, shared_buffer buffer, size_t size, size_t segment_size, udp_callback&& callback);
+
+/**
+ * Writes data over the udp as several datagrams, to an endpoint resolved in advance.
+ * See the overloads taking an address for more documentation.
+ *
+ * @param udp udp handle
+ * @param destination destination endpoint, see make_inet_endpoint
+ * @param buffer data to write
+ * @param segment_size size of each datagram
+ * @param callback callback on write finished
+ */
+void write_udp_segmented(udp udp, inet_endpoint destination, std::span<const uint8_t> buffer, size_t segment_size, udp_callback&& callback);
+void write_udp_segmented(udp udp, inet_endpoint destination, shared_buffer buffer, size_t size, size_t segment_size, udp_callback&& callback);
+
 #ifdef LOOPER_UNIX_SOCKETS
 
 unix_socket create_unix_socket(loop loop);
 void destroy_unix_socket(unix_socket unix_socket);
 void connect_unix_socket(unix_socket unix_socket, std::string_view path, connect_callback&& callback);
 void start_unix_socket_read(unix_socket unix_socket, read_callback&& callback);
+void start_unix_socket_read(unix_socket unix_socket, read_buffer_provider&& provider, read_callback&& callback);
 void stop_unix_socket_read(unix_socket unix_socket);
 void write_unix_socket(unix_socket unix_socket, std::span<const uint8_t> buffer, write_callback&& callback);
+void write_unix_socket(unix_socket unix_socket, std::unique_ptr<uint8_t[]>&& buffer, size_t size, write_callback&& callback);
+void write_unix_socket(unix_socket unix_socket, std::vector<uint8_t>&& buffer, write_callback&& callback);
+void write_unix_socket(unix_socket unix_socket, shared_buffer buffer, size_t size, write_callback&& callback);
 
 unix_socket_server create_unix_socket_server(loop loop);
 void destroy_unix_socket_server(unix_socket_server unix_socket);
@@ -161,10 +161,11 @@ using unix_socket_server_holder = handle_holder<unix_socket_server, unix_socket_
  * Calls looper::create to create a new loop and returns it in a holder.
  * See the used function for more documentation.
  *
+ * @param options options for the loop's behaviour
  * @return handle holder with new loop handle
  */
-inline loop_holder make_loop() {
-    return loop_holder(create());
+inline loop_holder make_loop(const loop_options& options = {}) {
+    return loop_holder(create(options));
 }
 
 /**
@@ -193,8 +194,10 @@ inline event_holder make_event(const loop loop, event_callback&& callback) {
  *
  * @return handle holder with new timer handle
  */
-inline timer_holder make_timer(const loop loop, const std::chrono::milliseconds timeout, timer_callback&& callback) {
-    return timer_holder(create_timer(loop, timeout, std::move(callback)));
+inline timer_holder make_timer(const loop loop, const std::chrono::nanoseconds timeout, timer_callback&& callback,
+                               const timer_mode mode = timer_mode::oneshot,
+                               const std::chrono::nanoseconds slack = no_slack) {
+    return timer_holder(create_timer(loop, timeout, std::move(callback), mode, slack));
 }
 
 /**
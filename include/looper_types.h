@@ -2,17 +2,19 @@
 
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <span>
 
 namespace looper {
 
-using handle = uint32_t;
+using handle = uint64_t;
 using error = int32_t;
 
 static constexpr auto error_unknown = static_cast<error>(-1);
 static constexpr handle empty_handle = static_cast<handle>(-1);
 static constexpr auto no_timeout = std::chrono::milliseconds(0);
 static constexpr auto no_delay = std::chrono::milliseconds(0);
+static constexpr auto no_slack = std::chrono::nanoseconds(0);
 
 using loop = handle;
 using future = handle;
@@ -59,16 +61,97 @@ struct inet_address {
     inet_address& operator=(const inet_address_view&);
 };
 
+// an IPv4 address and port in binary form. unlike inet_address, it is trivially copyable, and
+// using it requires no parsing or formatting of the ip. see make_inet_endpoint.
+struct inet_endpoint {
+    // in network byte order
+    uint32_t ip{};
+    uint16_t port{};
+};
+
+enum class timer_mode {
+    // timer fires once per start or reset
+    oneshot,
+    // timer re-arms itself every timeout, staying aligned to its start time.
+    // ticks missed due to a late loop are skipped, producing a single callback.
+    periodic_skip,
+    // timer re-arms itself every timeout. ticks missed due to a late loop are coalesced
+    // into a single callback, and the schedule is re-based from the current time.
+    periodic_coalesce
+};
+
+struct loop_options {
+    // registers sockets of the loop as edge-triggered. each readiness event is then used to read or write
+    // until the socket would block (within a fairness limit), instead of once per poll. this greatly reduces
+    // the amount of polls for bulk transfers.
+    bool edge_triggered_io = false;
+    // size of the buffer used for reading from sockets. a single read, and thus a single read callback,
+    // provides at most this amount of data. the buffer is shared by all sockets of the loop.
+    size_t read_buffer_size = 64 * 1024;
+};
+
+struct loop_stats {
+    // amount of times the loop returned from waiting on the os
+    uint64_t wakeups;
+    // amount of wakeups in which the loop had nothing to do (no callbacks or updates)
+    uint64_t idle_wakeups;
+    // amount of events received from the os
+    uint64_t events;
+    // amount of wakeups in which the os filled the whole event batch, so more events may have been left
+    // for the next wakeup. the batch grows while this happens, see events / wakeups for the average batch.
+    uint64_t full_event_batches;
+    // amount of wakeups in which at least one timer fired
+    uint64_t timer_wakeups;
+    // amount of timer wakeups saved by firing several timers in the same wakeup
+    uint64_t coalesced_timer_wakeups;
+    // amount of calls made to the os to register, modify or remove resources in the poller
+    uint64_t poller_updates;
+    // amount of requested resource event changes that did not require a call to the os, because they
+    // were merged with other changes or did not change what the os already had
+    uint64_t elided_poller_updates;
+};
+
+// data buffer shared with the library. the data is released with the last reference, which allows
+// releasing it with any custom deleter.
+using shared_buffer = std::shared_ptr<const uint8_t[]>;
+
 using loop_callback = std::function<void(loop)>;
 using future_callback = std::function<void(future)>;
 using event_callback = std::function<void(event)>;
 using timer_callback = std::function<void(timer)>;
 using read_callback = std::function<void(handle, std::span<const uint8_t>, error)>;
+// provides the buffer to read the next data into. the returned buffer must remain valid until the read callback
+// is called. if an empty buffer is returned, the loop's own buffer is used for that read.
+using read_buffer_provider = std::function<std::span<uint8_t>(handle)>;
 using write_callback = std::function<void(handle, error)>;
 using connect_callback = std::function<void(handle, error)>;
 using listen_callback = std::function<void(handle)>;
 using udp_callback = std::function<void(udp, error)>;
 using udp_read_callback = std::function<void(udp, inet_address_view, std::span<const uint8_t>, error)>;
+using udp_endpoint_read_callback = std::function<void(udp, inet_endpoint, std::span<const uint8_t>, error)>;
+
+// a datagram received as part of a batch. only valid during the callback it was given to.
+struct udp_datagram {
+    inet_endpoint sender;
+    std::span<const uint8_t> data;
+};
+
+using udp_batch_read_callback = std::function<void(udp, std::span<const udp_datagram>, error)>;
+
+// data holds one or more datagrams of the same sender, each of segment_size except the last which may be shorter
+using udp_segmented_read_callback = std::function<void(udp, inet_endpoint, std::span<const uint8_t>, size_t, error)>;
+
+// a datagram to send as part of a batch, to an endpoint resolved in advance
+struct udp_message {
+    inet_endpoint destination;
+    std::span<const uint8_t> data;
+};
+
+// a datagram to send as part of a batch, to an address which is resolved when sent
+struct udp_address_message {
+    inet_address_view destination;
+    std::span<const uint8_t> data;
+};
 
 #ifdef LOOPER_UNIX_SOCKETS
 using unix_socket_callback = std::function<void(unix_socket, error)>;
@@ -92,7 +175,9 @@ enum : error {
     error_no_such_handle,
     error_invalid_state,
     error_resource_errored,
-    error_already_reading
+    error_already_reading,
+    error_invalid_address,
+    error_invalid_argument
 };
 
 }
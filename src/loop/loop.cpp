@@ -10,31 +10,53 @@ namespace looper::impl {
 constexpr event_type must_have_events = event_type::error | event_type::hung;
 constexpr auto exec_later_wait_timeout = std::chrono::milliseconds(5000);
 
-loop::loop(const looper::loop handle) noexcept
+loop::loop(const looper::loop handle, const loop_options& options) noexcept
     : m_handle(handle)
+    , m_options(options)
     , m_mutex()
     , m_poller(os::poller::create())
-    , m_timeout(initial_poll_timeout)
     , m_run_loop_event(os::event::create())
-    , m_event_data()
+    , m_run_loop_resource(empty_handle)
+    , m_run_signalled(false)
+    , m_run_thread()
+    , m_deadline_timer(os::timer::create())
+    , m_deadline_timer_resource(empty_handle)
+    , m_armed_deadline(no_deadline)
+    , m_event_data(min_events_for_process)
+    , m_event_batch_size(min_events_for_process)
+    , m_sparse_event_batches(0)
+    , m_read_buffer_size(std::max(options.read_buffer_size, min_read_buffer_size))
+    // not initialized, as it is always written by a read before being used
+    , m_read_buffer(new uint8_t[m_read_buffer_size])
     , m_stop(false)
     , m_executing(false)
     , m_run_finished()
     , m_resource_table(0, handles::type_resource)
-    , m_descriptor_map()
     , m_futures()
     , m_timers()
+    , m_tasks()
+    , m_task_pool()
+    , m_free_tasks()
+    , m_next_task_sequence(0)
     , m_updates()
-    , m_invoke_callbacks() {
-    m_updates.resize(initial_reserve_size);
+    , m_invoke_callbacks()
+    , m_pending_resources()
+    , m_stats() {
 
     looper_trace_info(log_module, "creating loop: handle=%lu", m_handle);
 
-    add_resource(os::get_descriptor(m_run_loop_event),
+    m_run_loop_resource = add_resource(os::get_descriptor(m_run_loop_event),
                  event_type::in,
                  [this](resource, void*, event_type)->void {
                      ABORT_IF_ERROR(os::event_clear(m_run_loop_event));
                  });
+    // all timer and future deadlines are tracked by this single timer, which is re-armed to the
+    // earliest deadline before each poll. this gives us sub-millisecond precision for them.
+    m_deadline_timer_resource = add_resource(os::get_descriptor(m_deadline_timer),
+                 event_type::in,
+                 [this](resource, void*, event_type)->void {
+                     ABORT_IF_ERROR(os::timer_clear(m_deadline_timer));
+                 });
 }
 
 loop::~loop() noexcept {
@@ -51,6 +73,13 @@ loop::~loop() noexcept {
         });
     }
 
+    while (const auto* update = m_updates.pop()) {
+        delete update;
+    }
+    while (const auto* invoke = m_invoke_callbacks.pop()) {
+        delete invoke;
+    }
+
     lock.unlock();
 }
 
@@ -58,6 +87,14 @@ loop::~loop() noexcept {
     return m_handle;
 }
 
+const loop_options& loop::options() const {
+    return m_options;
+}
+
+std::span<uint8_t> loop::read_buffer() noexcept {
+    return {m_read_buffer.get(), m_read_buffer_size};
+}
+
 std::unique_lock<std::mutex> loop::lock_loop() noexcept {
     return std::unique_lock(m_mutex);
 }
@@ -69,26 +106,15 @@ resource loop::add_resource(
     void* user_ptr) noexcept {
     auto [lock, _1] = lock_if_needed();
 
-    const auto it = m_descriptor_map.find(descriptor);
-    if (it != m_descriptor_map.end()) {
-        looper_trace_error(log_module, "resource %u already added", descriptor);
-        std::abort();
-    }
-
-    auto [handle, data] = m_resource_table.allocate_new();
-    data->user_ptr = user_ptr;
-    data->descriptor = descriptor;
-    data->events = event_type::none;
-    data->callback = std::move(callback);
+    auto [handle, data] = m_resource_table.assign_new();
+    data.user_ptr = user_ptr;
+    data.descriptor = descriptor;
+    data.events = event_type::none;
+    data.callback = std::move(callback);
 
     looper_trace_debug(log_module, "adding resource: loop=%lu, handle=%lu, fd=%u", m_handle, handle, descriptor);
 
-    auto [_2, data_ptr] = m_resource_table.assign(handle, std::move(data));
-
-    m_descriptor_map.emplace(descriptor, &data_ptr);
-    m_updates.push_back({handle, update::type_add, events});
-
-    signal_run();
+    push_update(handle, update::type_add, events);
 
     return handle;
 }
@@ -100,20 +126,24 @@ void loop::remove_resource(const resource resource) noexcept {
 
     looper_trace_debug(log_module, "removing resource: loop=%lu, handle=%lu", m_handle, resource);
 
-    m_descriptor_map.erase(data->descriptor);
-    ABORT_IF_ERROR(os::poller_remove(m_poller, data->descriptor));
+    if (data->registered) {
+        ABORT_IF_ERROR(os::poller_remove(m_poller, data->descriptor));
+        m_stats.poller_updates++;
+    }
 
     signal_run();
 }
 
+bool loop::has_resource(const resource resource) noexcept {
+    auto [lock, _] = lock_if_needed();
+    return m_resource_table.has(resource);
+}
+
 void loop::request_resource_events(
     const resource resource,
     const event_type events,
     const events_update_type type) noexcept {
-    auto [lock, _] = lock_if_needed();
-
-    const auto& data = m_resource_table[resource];
-
+    // no lock needed, the update is validated against the resource table when the loop processes it
     update::update_type update_type;
     switch (type) {
         case events_update_type::override:
@@ -125,6 +155,9 @@ void loop::request_resource_events(
         case events_update_type::remove:
             update_type = update::type_new_events_remove;
             break;
+        case events_update_type::rearm:
+            update_type = update::type_rearm;
+            break;
         default:
             ABORT("unsupported update type");
     }
@@ -132,14 +165,16 @@ void loop::request_resource_events(
     looper_trace_debug(log_module, "modifying resource events: loop=%lu, handle=%lu, type=%d, events=0x%x",
                        m_handle, resource, static_cast<uint8_t>(update_type), events);
 
-    m_updates.push_back({data.our_handle, update_type, events});
-    signal_run();
+    push_update(resource, update_type, events);
 }
 
 void loop::add_future(future_data* data) noexcept {
     auto [lock, _] = lock_if_needed();
 
-    m_futures.push_back(data);
+    m_futures.push(data);
+
+    // the loop may be sleeping past this deadline, so wake it to re-calculate its poll timeout
+    signal_run();
 }
 
 void loop::remove_future(future_data* data) noexcept {
@@ -151,7 +186,13 @@ void loop::remove_future(future_data* data) noexcept {
 void loop::add_timer(timer_data* data) noexcept {
     auto [lock, _] = lock_if_needed();
 
-    m_timers.push_back(data);
+    m_timers.push(data);
+
+    // the deadline timer is armed by the slack of all the timers, so even a timer which is not first may be
+    // due before it. in that case the loop may be sleeping past this deadline, so wake it to re-arm.
+    if (m_armed_deadline == no_deadline || data->next_timestamp + data->slack < m_armed_deadline) {
+        signal_run();
+    }
 }
 
 void loop::remove_timer(timer_data* data) noexcept {
@@ -161,45 +202,55 @@ void loop::remove_timer(timer_data* data) noexcept {
 }
 
 void loop::invoke_from_loop(loop_callback&& callback) noexcept {
-    auto [lock, _] = lock_if_needed();
-
-    m_invoke_callbacks.emplace_back(std::move(callback));
+    m_invoke_callbacks.push(new invoke_data(std::move(callback)));
+    signal_run();
 }
 
-void loop::set_timeout_if_smaller(const std::chrono::milliseconds timeout) noexcept {
+void loop::invoke_from_loop_at(const std::chrono::nanoseconds deadline, loop_callback&& callback) noexcept {
     auto [lock, _] = lock_if_needed();
 
-    if (m_timeout > timeout) {
-        m_timeout = timeout;
+    task_data* task;
+    if (m_free_tasks.empty()) {
+        task = &m_task_pool.emplace_back();
+    } else {
+        task = m_free_tasks.back();
+        m_free_tasks.pop_back();
     }
-}
 
-void loop::reset_smallest_timeout() noexcept {
-    auto [lock, _] = lock_if_needed();
+    task->execute_time = deadline;
+    task->sequence = m_next_task_sequence++;
+    task->callback = std::move(callback);
+    m_tasks.push(task);
 
-    std::chrono::milliseconds timeout = initial_poll_timeout;
-    for (const auto* timer : m_timers) {
-        if (timer->timeout < timeout) {
-            timeout = timer->timeout;
-        }
+    if (m_tasks.top() == task) {
+        // the loop may be sleeping past this deadline, so wake it to re-calculate its poll timeout
+        signal_run();
     }
-
-    m_timeout = timeout;
 }
 
 void loop::signal_run() noexcept {
-    auto [lock, _] = lock_if_needed();
+    if (m_run_thread.load() == std::this_thread::get_id()) {
+        // called from within the loop, which re-checks for work before it polls again
+        return;
+    }
+
+    if (m_run_signalled.exchange(true)) {
+        // already signalled since the loop started its current run, it will see our changes
+        return;
+    }
 
     looper_trace_debug(log_module, "signalling loop run: loop=%lu", m_handle);
     ABORT_IF_ERROR(os::event_set(m_run_loop_event));
 }
 
-bool loop::run_once() noexcept {
-    auto [lock, locked] = lock_if_needed();
-    if (!locked) {
-        looper_trace_error(log_module, "run_once was unable to own a lock as it is held by the caller");
-        std::abort();
-    }
+loop_stats loop::stats() noexcept {
+    auto [lock, _] = lock_if_needed();
+    return m_stats;
+}
+
+bool loop::run_once(const std::chrono::milliseconds max_timeout) noexcept {
+    // never called with the loop locked, but other threads may hold it for a short while to use the loop's objects
+    auto lock = lock_loop();
 
     if (m_stop) {
         looper_trace_debug(log_module, "looper marked stop, not running");
@@ -207,18 +258,28 @@ bool loop::run_once() noexcept {
     }
 
     m_executing = true;
+    m_run_thread.store(std::this_thread::get_id());
     looper_trace_debug(log_module, "start looper run");
 
+    // anything submitted from here on is either seen by the checks below before polling, or signals the loop.
+    m_run_signalled.store(false);
+
     process_updates();
 
+    arm_deadline_timer();
+    auto timeout = get_poll_timeout();
+    if (max_timeout != infinite_poll_timeout && (timeout == infinite_poll_timeout || timeout > max_timeout)) {
+        timeout = max_timeout;
+    }
+
     size_t event_count;
     lock.unlock();
     {
         const auto status = os::poller_poll(
             m_poller,
-            max_events_for_process,
-            m_timeout,
-            m_event_data,
+            m_event_batch_size,
+            timeout,
+            m_event_data.data(),
             event_count);
         if (status == error_interrupted) {
             // timeout
@@ -230,51 +291,142 @@ bool loop::run_once() noexcept {
     }
     lock.lock();
 
+    // apply updates requested while we were waiting, this is usually the reason we were woken up.
+    size_t work_count = process_updates();
+
     if (event_count != 0) {
-        process_events(lock, event_count);
+        work_count += process_events(lock, event_count);
     }
+    adapt_event_batch_size(event_count);
+
+    work_count += process_timers(lock);
+    work_count += process_futures(lock);
+    work_count += process_tasks(lock);
+    work_count += process_invokes(lock);
 
-    process_timers(lock);
-    process_futures(lock);
-    process_invokes(lock);
+    m_stats.wakeups++;
+    if (work_count == 0) {
+        m_stats.idle_wakeups++;
+    }
 
     looper_trace_debug(log_module, "finish looper run");
+    m_run_thread.store(std::thread::id());
     m_executing = false;
     m_run_finished.notify_all();
 
     return m_stop;
 }
 
-void loop::process_timers(std::unique_lock<std::mutex>& lock) const noexcept {
+std::chrono::nanoseconds loop::get_next_deadline() const noexcept {
+    auto deadline = no_deadline;
+    if (!m_timers.empty()) {
+        // wake up at the latest time which still respects the slack of every timer. timers whose
+        // next timestamp has passed by then are fired in the same wakeup.
+        const auto* top = m_timers.top();
+        deadline = top->next_timestamp + top->slack;
+        m_timers.visit([&deadline](const timer_data* timer)->bool {
+            if (timer->next_timestamp >= deadline) {
+                return false;
+            }
+
+            deadline = std::min(deadline, timer->next_timestamp + timer->slack);
+            return true;
+        });
+    }
+    if (!m_futures.empty() && (deadline == no_deadline || m_futures.top()->execute_time < deadline)) {
+        deadline = m_futures.top()->execute_time;
+    }
+    if (!m_tasks.empty() && (deadline == no_deadline || m_tasks.top()->execute_time < deadline)) {
+        deadline = m_tasks.top()->execute_time;
+    }
+
+    return deadline;
+}
+
+std::chrono::milliseconds loop::get_poll_timeout() const noexcept {
+    if (!m_invoke_callbacks.empty()) {
+        return std::chrono::milliseconds(0);
+    }
+
+    // deadlines are handled by the deadline timer waking the poll, and anything submitted from
+    // other threads signals the loop. with nothing of those, there is no reason to wake up.
+    return infinite_poll_timeout;
+}
+
+void loop::arm_deadline_timer() noexcept {
+    const auto deadline = get_next_deadline();
+    if (deadline == m_armed_deadline) {
+        return;
+    }
+
+    if (deadline == no_deadline) {
+        looper_trace_debug(log_module, "disarming deadline timer: loop=%lu", m_handle);
+        ABORT_IF_ERROR(os::timer_disarm(m_deadline_timer));
+    } else {
+        looper_trace_debug(log_module, "arming deadline timer: loop=%lu, deadline=%lu", m_handle, deadline.count());
+        ABORT_IF_ERROR(os::timer_arm(m_deadline_timer, deadline));
+    }
+
+    m_armed_deadline = deadline;
+}
+
+size_t loop::process_timers(std::unique_lock<std::mutex>& lock) noexcept {
     std::vector<loop_timer_callback> to_call;
 
+    // timers are ordered by their next timestamp, so only expired timers are visited.
+    // a hit oneshot timer leaves the schedule until it is started or reset again, while periodic
+    // timers are re-scheduled right away into the future, so each is visited once.
+    // a timer only saved a wakeup if it was not yet due when the first timer was, and the first timer's
+    // slack is what let them share this wakeup. timers due at the same time would share it anyway.
+    std::chrono::nanoseconds first_deadline{};
+    std::chrono::nanoseconds slack_window_end{};
+    size_t coalesced = 0;
+
     const auto now = time_now();
-    for (auto* timer : m_timers) {
-        if (timer->hit || timer->next_timestamp > now) {
-            continue;
-        }
+    while (!m_timers.empty() && m_timers.top()->next_timestamp <= now) {
+        auto* timer = m_timers.top();
 
         looper_trace_debug(log_module, "timer hit: ptr=0x%x", timer);
 
-        timer->hit = true;
+        if (to_call.empty()) {
+            first_deadline = timer->next_timestamp;
+            slack_window_end = timer->next_timestamp + timer->slack;
+        } else if (timer->next_timestamp > first_deadline && timer->next_timestamp <= slack_window_end) {
+            coalesced++;
+        }
+
+        if (timer->mode == timer_mode::oneshot) {
+            m_timers.pop();
+        } else {
+            reschedule_periodic_timer(timer, now);
+            m_timers.update(timer);
+        }
+
         to_call.push_back(timer->callback);
     }
 
+    if (!to_call.empty()) {
+        m_stats.timer_wakeups++;
+        m_stats.coalesced_timer_wakeups += coalesced;
+    }
+
     lock.unlock();
     for (const auto& callback : to_call) {
         invoke_func_nolock("timer_callback", callback);
     }
     lock.lock();
+
+    return to_call.size();
 }
 
-void loop::process_futures(std::unique_lock<std::mutex>& lock) const noexcept {
+size_t loop::process_futures(std::unique_lock<std::mutex>& lock) noexcept {
     std::vector<loop_future_callback> to_call;
 
+    // futures are ordered by their execution time, so only due futures are visited.
+    // a due future leaves the queue until executed again.
     const auto now = time_now();
-    for (auto* future : m_futures) {
-        if (future->finished || future->execute_time > now) {
-            continue;
-        }
+    while (!m_futures.empty() && m_futures.top()->execute_time <= now) {
+        auto* future = m_futures.pop();
 
         looper_trace_debug(log_module, "future finished: ptr=0x%x", future);
 
@@ -287,6 +439,50 @@ void loop::process_futures(std::unique_lock<std::mutex>& lock) const noexcept {
         invoke_func_nolock("future_callback", callback);
     }
     lock.lock();
+
+    return to_call.size();
+}
+
+size_t loop::process_tasks(std::unique_lock<std::mutex>& lock) noexcept {
+    std::vector<loop_callback> to_call;
+
+    const auto now = time_now();
+    while (!m_tasks.empty() && m_tasks.top()->execute_time <= now) {
+        auto* task = m_tasks.pop();
+
+        to_call.push_back(std::move(task->callback));
+        task->callback = nullptr;
+        m_free_tasks.push_back(task);
+    }
+
+    lock.unlock();
+    for (const auto& callback : to_call) {
+        invoke_func_nolock("task_callback", callback);
+    }
+    lock.lock();
+
+    return to_call.size();
+}
+
+void loop::reschedule_periodic_timer(timer_data* timer, const std::chrono::nanoseconds now) noexcept {
+    // advance from the previous deadline rather than from now, so callback latency does not accumulate
+    timer->next_timestamp += timer->timeout;
+    if (timer->next_timestamp > now) {
+        return;
+    }
+
+    switch (timer->mode) {
+        case timer_mode::periodic_skip: {
+            const auto missed = (now - timer->next_timestamp) / timer->timeout + 1;
+            timer->next_timestamp += missed * timer->timeout;
+            break;
+        }
+        case timer_mode::periodic_coalesce:
+            timer->next_timestamp = now + timer->timeout;
+            break;
+        default:
+            break;
+    }
 }
 
 void loop::process_update(const update& update) noexcept {
@@ -296,64 +492,112 @@ void loop::process_update(const update& update) noexcept {
 
     auto& data = m_resource_table[update.handle];
 
+    // only the wanted events are changed here. several updates to the same resource are common (e.g. enabling
+    // and disabling write events around a write), so the poller is only updated once all queued updates were applied.
     switch (update.type) {
         case update::type_add: {
             data.events = update.events | must_have_events;
-            ABORT_IF_ERROR(os::poller_add(m_poller, data.descriptor, data.events));
             break;
         }
         case update::type_new_events: {
-            data.events = update.events | must_have_events;
-            ABORT_IF_ERROR(os::poller_set(m_poller, data.descriptor, data.events));
+            // the edge flag is part of how the resource was registered, and is not changed by event updates
+            data.events = update.events | must_have_events | (data.events & event_type::edge);
             break;
         }
         case update::type_new_events_add: {
             data.events |= update.events | must_have_events;
-            ABORT_IF_ERROR(os::poller_set(m_poller, data.descriptor, data.events));
             break;
         }
         case update::type_new_events_remove: {
-            data.events &= ~update.events;
+            data.events &= ~(update.events & ~event_type::edge);
             data.events |= must_have_events;
-            ABORT_IF_ERROR(os::poller_set(m_poller, data.descriptor, data.events));
+            break;
+        }
+        case update::type_rearm: {
+            data.rearm = true;
             break;
         }
     }
-}
 
-void loop::process_updates() noexcept {
-    while (!m_updates.empty()) {
-        auto& update = m_updates.front();
-        process_update(update);
+    if (data.update_pending) {
+        m_stats.elided_poller_updates++;
+    } else {
+        data.update_pending = true;
+        m_pending_resources.push_back(data.our_handle);
+    }
+}
 
-        m_updates.pop_front();
+void loop::flush_resource_update(resource_data& data) noexcept {
+    data.update_pending = false;
+
+    if (!data.registered) {
+        ABORT_IF_ERROR(os::poller_add(m_poller, data.descriptor, data.events, data.our_handle));
+        data.registered = true;
+    } else if (data.events != data.registered_events || data.rearm) {
+        ABORT_IF_ERROR(os::poller_set(m_poller, data.descriptor, data.events, data.our_handle));
+    } else {
+        // the poller already has these events
+        m_stats.elided_poller_updates++;
+        return;
     }
+
+    data.registered_events = data.events;
+    data.rearm = false;
+    m_stats.poller_updates++;
 }
 
-void loop::process_invokes(std::unique_lock<std::mutex>& lock) noexcept {
-    while (!m_invoke_callbacks.empty()) {
-        auto& callback = m_invoke_callbacks.front();
-        invoke_func(lock, "loop_invoke_callback", callback);
+void loop::push_update(const resource handle, const update::update_type type, const event_type events) noexcept {
+    m_updates.push(new update(handle, type, events));
+    signal_run();
+}
+
+size_t loop::process_updates() noexcept {
+    size_t count = 0;
+    while (const auto* update = m_updates.pop()) {
+        process_update(*update);
+        delete update;
+        count++;
+    }
 
-        m_invoke_callbacks.pop_front();
+    for (const auto handle : m_pending_resources) {
+        // resources may have been removed since the update was queued
+        if (m_resource_table.has(handle)) {
+            flush_resource_update(m_resource_table[handle]);
+        }
     }
+    m_pending_resources.clear();
+
+    return count;
 }
 
-void loop::process_events(std::unique_lock<std::mutex>& lock, const size_t event_count) noexcept {
-    for (int i = 0; i < event_count; i++) {
-        auto& current_event_data = m_event_data[i];
+size_t loop::process_invokes(std::unique_lock<std::mutex>& lock) noexcept {
+    // the queue is drained without holding the lock, which leaves it free for producers
+    size_t count = 0;
+    lock.unlock();
+    while (const auto* invoke = m_invoke_callbacks.pop()) {
+        invoke_func_nolock("loop_invoke_callback", invoke->callback);
+        delete invoke;
+        count++;
+    }
+    lock.lock();
 
-        auto it = m_descriptor_map.find(current_event_data.descriptor);
-        if (it == m_descriptor_map.end()) {
-            // make sure to remove this fd, guess it somehow was left over
-            looper_trace_debug(log_module, "resource received events, but isn't attached to anything: fd=%lu", current_event_data.descriptor);
+    return count;
+}
 
-            ABORT_IF_ERROR(os::poller_remove(m_poller, current_event_data.descriptor));
+size_t loop::process_events(std::unique_lock<std::mutex>& lock, const size_t event_count) noexcept {
+    size_t count = 0;
+    for (int i = 0; i < event_count; i++) {
+        auto& current_event_data = m_event_data[i];
 
+        // the resource handle is registered with the poller, so the resource is found directly in the table
+        const auto handle = static_cast<resource>(current_event_data.user_data);
+        if (!m_resource_table.has(handle)) {
+            // resource was removed after the events were reported
+            looper_trace_debug(log_module, "resource received events, but was already removed: handle=%lu", handle);
             continue;
         }
 
-        const auto* resource_data = it->second;
+        const auto* resource_data = &m_resource_table[handle];
 
         if ((current_event_data.events & (event_type::error | event_type::hung)) != 0) {
             // we got an error on the resource, push it into the resource handler by marking
@@ -369,9 +613,44 @@ void loop::process_events(std::unique_lock<std::mutex>& lock, const size_t event
         looper_trace_debug(log_module, "resource has events: loop=%lu, handle=%lu, events=0x%x",
                            m_handle, resource_data->our_handle, adjusted_flags);
 
+        if (resource_data->our_handle != m_run_loop_resource && resource_data->our_handle != m_deadline_timer_resource) {
+            count++;
+        }
+
         invoke_func(lock, "resource_callback",
                     resource_data->callback, resource_data->our_handle, resource_data->user_ptr, adjusted_flags);
     }
+
+    return count;
+}
+
+void loop::adapt_event_batch_size(const size_t event_count) noexcept {
+    // a full batch means more events are likely waiting, so take more next time. a batch that stays
+    // mostly empty for a while means we can shrink back. the event buffer grows with the batch, but is
+    // kept when the batch shrinks, so a busy loop only reallocates it a few times.
+    auto new_size = m_event_batch_size;
+    if (event_count >= m_event_batch_size) {
+        new_size = std::min(m_event_batch_size * 2, max_events_for_process);
+        m_sparse_event_batches = 0;
+        m_stats.full_event_batches++;
+    } else if (event_count < m_event_batch_size / 4) {
+        if (++m_sparse_event_batches >= event_batch_shrink_polls) {
+            new_size = std::max(m_event_batch_size / 2, min_events_for_process);
+            m_sparse_event_batches = 0;
+        }
+    } else {
+        m_sparse_event_batches = 0;
+    }
+
+    if (new_size != m_event_batch_size) {
+        looper_trace_debug(log_module, "adapting event batch size: loop=%lu, size=%lu", m_handle, new_size);
+        m_event_batch_size = new_size;
+        if (m_event_data.size() < new_size) {
+            m_event_data.resize(new_size);
+        }
+    }
+
+    m_stats.events += event_count;
 }
 
 std::pair<std::unique_lock<std::mutex>, bool> loop::lock_if_needed() noexcept {
@@ -380,8 +659,8 @@ std::pair<std::unique_lock<std::mutex>, bool> loop::lock_if_needed() noexcept {
     return {std::move(lock), locked};
 }
 
-std::chrono::milliseconds time_now() {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(
+std::chrono::nanoseconds time_now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
             std::chrono::steady_clock::now().time_since_epoch());
 }
 
@@ -3,15 +3,18 @@
 #include <memory>
 #include <deque>
 #include <mutex>
-#include <unordered_map>
 #include <condition_variable>
 #include <chrono>
-#include <list>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include "looper_types.h"
 
 #include "os/os.h"
 #include "util/handles.h"
+#include "util/heap.h"
+#include "util/mpsc_queue.h"
 #include "util/util.h"
 #include "types_internal.h"
 
@@ -28,76 +31,156 @@ using loop_timer_callback = std::function<void()>;
 using loop_future_callback = std::function<void()>;
 using loop_ptr = std::shared_ptr<loop>;
 
-static constexpr size_t max_events_for_process = 20;
+// the amount of events taken from the poller per run adapts to the load, within these limits
+static constexpr size_t min_events_for_process = 20;
+static constexpr size_t max_events_for_process = 4096;
+// the batch only shrinks after this many polls in a row used little of it, so the remainder of a burst
+// taken right after a full batch does not shrink it back
+static constexpr size_t event_batch_shrink_polls = 16;
 static constexpr size_t initial_reserve_size = 20;
-static constexpr auto initial_poll_timeout = std::chrono::milliseconds(1000);
-static constexpr auto min_poll_timeout = std::chrono::milliseconds(100);
-static constexpr size_t resource_table_size = 256;
+// waits on the poller until woken by an event, the deadline timer or a signal from another thread
+static constexpr auto infinite_poll_timeout = std::chrono::milliseconds(-1);
+static constexpr auto no_deadline = std::chrono::nanoseconds(0);
+static constexpr size_t resource_table_size = 1 << 21;
+static constexpr size_t min_read_buffer_size = 1024;
 
 enum class events_update_type {
     override,
     append,
-    remove
+    remove,
+    // re-registers the current events. for edge-triggered resources, this makes the poller
+    // report current readiness again.
+    rearm
 };
 
 struct timer_data {
     timer_data()
         : timeout(0)
         , next_timestamp(0)
-        , hit(true)
+        , slack(0)
+        , heap_index(util::heap_npos)
+        , mode(timer_mode::oneshot)
         , callback(nullptr)
     {}
 
-    std::chrono::milliseconds timeout;
-    std::chrono::milliseconds next_timestamp;
-    bool hit;
+    std::chrono::nanoseconds timeout;
+    std::chrono::nanoseconds next_timestamp;
+    // how late the timer may fire past next_timestamp, to share a wakeup with other timers
+    std::chrono::nanoseconds slack;
+    size_t heap_index;
+    timer_mode mode;
     loop_timer_callback callback;
 };
 
+struct timer_data_compare {
+    bool operator()(const timer_data* lhs, const timer_data* rhs) const {
+        return lhs->next_timestamp < rhs->next_timestamp;
+    }
+};
+
 struct future_data {
     future_data()
         : finished(true)
         , execute_time(0)
+        , heap_index(util::heap_npos)
         , callback(nullptr)
     {}
 
     bool finished;
-    std::chrono::milliseconds execute_time;
+    std::chrono::nanoseconds execute_time;
+    size_t heap_index;
     loop_future_callback callback;
 };
 
+struct future_data_compare {
+    bool operator()(const future_data* lhs, const future_data* rhs) const {
+        return lhs->execute_time < rhs->execute_time;
+    }
+};
+
+// a one-off callback posted to the loop. these are pooled by the loop and have no handle.
+struct task_data {
+    task_data()
+        : execute_time(0)
+        , sequence(0)
+        , heap_index(util::heap_npos)
+        , callback(nullptr)
+    {}
+
+    std::chrono::nanoseconds execute_time;
+    // order in which tasks were posted, so tasks with the same execute time run in that order
+    uint64_t sequence;
+    size_t heap_index;
+    loop_callback callback;
+};
+
+struct task_data_compare {
+    bool operator()(const task_data* lhs, const task_data* rhs) const {
+        if (lhs->execute_time != rhs->execute_time) {
+            return lhs->execute_time < rhs->execute_time;
+        }
+        return lhs->sequence < rhs->sequence;
+    }
+};
+
 struct resource_data {
     explicit resource_data(const resource handle)
         : our_handle(handle)
         , user_ptr(nullptr)
         , descriptor(-1)
         , events(event_type::none)
+        , registered_events(event_type::none)
+        , registered(false)
+        , rearm(false)
+        , update_pending(false)
         , callback(nullptr)
     {}
 
     resource our_handle;
     void* user_ptr;
     os::descriptor descriptor;
+    // events wanted for the resource
     event_type events;
+    // events last given to the poller, updated once pending updates are flushed
+    event_type registered_events;
+    bool registered;
+    // the poller must be updated even if the events did not change
+    bool rearm;
+    bool update_pending;
     resource_callback callback;
 };
 
-struct update {
+struct update : util::mpsc_node {
     enum update_type {
         type_add,
         type_new_events,
         type_new_events_add,
         type_new_events_remove,
+        type_rearm,
     };
 
+    update(const resource handle, const update_type type, const event_type events)
+        : handle(handle)
+        , type(type)
+        , events(events)
+    {}
+
     resource handle;
     update_type type;
     event_type events;
 };
 
+struct invoke_data : util::mpsc_node {
+    explicit invoke_data(loop_callback&& callback)
+        : callback(std::move(callback))
+    {}
+
+    loop_callback callback;
+};
+
 class loop {
 public:
-    explicit loop(looper::loop handle) noexcept;
+    loop(looper::loop handle, const loop_options& options) noexcept;
     ~loop() noexcept;
 
     loop(loop&) = delete;
@@ -106,6 +189,10 @@ public:
     loop& operator=(loop&&) = delete;
 
     [[nodiscard]] looper::loop handle() const;
+    [[nodiscard]] const loop_options& options() const;
+    // buffer for reading data from resources. may only be used from the loop thread, and the data
+    // in it is only valid until the next read.
+    [[nodiscard]] std::span<uint8_t> read_buffer() noexcept;
 
     std::unique_lock<std::mutex> lock_loop() noexcept;
 
@@ -114,51 +201,88 @@ public:
                           resource_callback&& callback,
                           void* user_ptr = nullptr) noexcept;
     void remove_resource(resource resource) noexcept;
+    [[nodiscard]] bool has_resource(resource resource) noexcept;
     void request_resource_events(resource resource, event_type events, events_update_type type) noexcept;
 
     void add_future(future_data* data) noexcept;
     void remove_future(future_data* data) noexcept;
+    // adds the timer to the schedule, or re-schedules it if already added
     void add_timer(timer_data* data) noexcept;
     void remove_timer(timer_data* data) noexcept;
 
     void invoke_from_loop(loop_callback&& callback) noexcept;
+    // runs the callback from the loop once the deadline (of time_now's clock) has passed
+    void invoke_from_loop_at(std::chrono::nanoseconds deadline, loop_callback&& callback) noexcept;
 
-    void set_timeout_if_smaller(std::chrono::milliseconds timeout) noexcept;
-    void reset_smallest_timeout() noexcept;
     void signal_run() noexcept;
 
-    // loop cannot be locked by current thread when this is called
-    bool run_once() noexcept;
+    [[nodiscard]] loop_stats stats() noexcept;
+
+    // loop cannot be locked by current thread when this is called.
+    // max_timeout bounds the wait for events, if not infinite_poll_timeout.
+    bool run_once(std::chrono::milliseconds max_timeout = infinite_poll_timeout) noexcept;
 
 private:
-    void process_timers(std::unique_lock<std::mutex>& lock) const noexcept;
-    void process_futures(std::unique_lock<std::mutex>& lock) const noexcept;
+    [[nodiscard]] std::chrono::nanoseconds get_next_deadline() const noexcept;
+    [[nodiscard]] std::chrono::milliseconds get_poll_timeout() const noexcept;
+    void arm_deadline_timer() noexcept;
+
+    size_t process_timers(std::unique_lock<std::mutex>& lock) noexcept;
+    size_t process_futures(std::unique_lock<std::mutex>& lock) noexcept;
+    size_t process_tasks(std::unique_lock<std::mutex>& lock) noexcept;
+    static void reschedule_periodic_timer(timer_data* timer, std::chrono::nanoseconds now) noexcept;
     void process_update(const update& update) noexcept;
-    void process_updates() noexcept;
-    void process_invokes(std::unique_lock<std::mutex>& lock) noexcept;
-    void process_events(std::unique_lock<std::mutex>& lock, size_t event_count) noexcept;
+    void push_update(resource handle, update::update_type type, event_type events) noexcept;
+    void flush_resource_update(resource_data& data) noexcept;
+    size_t process_updates() noexcept;
+    size_t process_invokes(std::unique_lock<std::mutex>& lock) noexcept;
+    size_t process_events(std::unique_lock<std::mutex>& lock, size_t event_count) noexcept;
+    void adapt_event_batch_size(size_t event_count) noexcept;
 
     std::pair<std::unique_lock<std::mutex>, bool> lock_if_needed() noexcept;
 
     looper::loop m_handle;
+    loop_options m_options;
     std::mutex m_mutex;
     os::poller m_poller;
-    std::chrono::milliseconds m_timeout;
     os::event m_run_loop_event;
-    os::interface::poll::event_data m_event_data[max_events_for_process];
+    resource m_run_loop_resource;
+    // set once the loop was signalled since it last started a run, so further signals can skip the event
+    std::atomic<bool> m_run_signalled;
+    // the thread currently inside run_once, which never needs to be signalled
+    std::atomic<std::thread::id> m_run_thread;
+    os::timer m_deadline_timer;
+    resource m_deadline_timer_resource;
+    std::chrono::nanoseconds m_armed_deadline;
+    // at least m_event_batch_size entries, grown with it
+    std::vector<os::interface::poll::event_data> m_event_data;
+    size_t m_event_batch_size;
+    // polls in a row which used little of the event batch
+    size_t m_sparse_event_batches;
+    size_t m_read_buffer_size;
+    std::unique_ptr<uint8_t[]> m_read_buffer;
 
     bool m_stop;
     bool m_executing;
     std::condition_variable m_run_finished;
 
-    handles::handle_table<resource_data, resource_table_size> m_resource_table;
-    std::unordered_map<os::descriptor, resource_data*> m_descriptor_map;
-    std::list<future_data*> m_futures;
-    std::list<timer_data*> m_timers;
-    std::deque<update> m_updates;
-    std::deque<loop_callback> m_invoke_callbacks;
+    // stored inline, so dispatching a batch of events walks dense slots instead of separate allocations
+    handles::handle_table<resource_data, resource_table_size, true> m_resource_table;
+    util::intrusive_heap<future_data, future_data_compare> m_futures;
+    util::intrusive_heap<timer_data, timer_data_compare> m_timers;
+    util::intrusive_heap<task_data, task_data_compare> m_tasks;
+    std::deque<task_data> m_task_pool;
+    std::vector<task_data*> m_free_tasks;
+    uint64_t m_next_task_sequence;
+    // filled from any thread without locking, drained by the loop thread
+    util::mpsc_queue<update> m_updates;
+    util::mpsc_queue<invoke_data> m_invoke_callbacks;
+    // resources changed by updates in the current run, which need to be given to the poller
+    std::vector<resource> m_pending_resources;
+
+    loop_stats m_stats;
 };
 
-std::chrono::milliseconds time_now();
+std::chrono::nanoseconds time_now();
 
 }
@@ -8,8 +8,8 @@ namespace looper::impl {
 event::event(const looper::event handle, const loop_ptr& loop, os::event&& event, event_callback&& callback) noexcept
     : m_handle(handle)
     , m_event_obj(std::move(event))
-    , m_resource(loop)
-    , m_callback(std::move(callback)) {
+    , m_callback(std::move(callback))
+    , m_resource(loop) {
     auto [lock, control] = m_resource.lock_loop();
     control.attach_to_loop(
         os::get_descriptor(m_event_obj),
@@ -17,8 +17,9 @@ private:
 
     looper::event m_handle;
     os::event m_event_obj;
-    loop_resource m_resource;
     event_callback m_callback;
+    // last, so it is detached from the loop before the members used by its events are destroyed
+    loop_resource m_resource;
 };
 
 }
@@ -36,9 +36,6 @@ looper::error future::execute(const std::chrono::milliseconds delay) noexcept {
     looper_trace_info(log_module, "queueing future: handle=%lu, run_at=%lu", m_handle, m_loop_data.execute_time.count());
 
     m_loop->add_future(&m_loop_data);
-    if (delay.count() < 1) {
-        m_loop->signal_run();
-    }
 
     return error_success;
 }
@@ -32,6 +32,18 @@ concept io_type = requires(
     { t.close() } -> std::same_as<void>;
 };
 
+// io which can write several queued requests with one call
+template<typename t_, typename wr_t_>
+concept batch_writable_io_type = requires(t_ t, const std::deque<wr_t_>& f1_requests, size_t f1_count, size_t& f1_written) {
+    { t.write(f1_requests, f1_count, f1_written) } -> std::same_as<looper::error>;
+};
+
+// io which sends each request whole as a datagram, and can send several queued requests with one call
+template<typename t_, typename wr_t_>
+concept batch_datagram_io_type = requires(t_ t, const std::deque<wr_t_>& f1_requests, size_t f1_count, size_t& f1_sent_count) {
+    { t.send(f1_requests, f1_count, f1_sent_count) } -> std::same_as<looper::error>;
+};
+
 template<typename t_, typename wr_t_, typename rd_t_>
 concept connectable_io_type = io_type<t_, wr_t_, rd_t_> && requires(t_ t) {
     { t.finalize_connect() } -> std::same_as<looper::error>;
@@ -55,6 +67,8 @@ struct base_io final {
     using read_data = t_rd_;
     using io_type = t_io_;
     using read_callback = std::function<void(looper::handle, const t_rd_&)>;
+    // called on the io object, under the same lock, right before reading starts
+    using read_preparer = std::function<looper::error(io_type&)>;
 
     base_io(looper::handle handle, const loop_ptr& loop, io_type&& io_obj) noexcept;
 
@@ -63,9 +77,10 @@ struct base_io final {
     base_io& operator=(const base_io&) = delete;
     base_io& operator=(base_io&&) = default;
 
-    [[nodiscard]] looper::error start_read(read_callback&& callback) noexcept;
+    [[nodiscard]] looper::error start_read(read_callback&& callback, read_buffer_provider&& provider = nullptr, read_preparer&& preparer = nullptr) noexcept;
     [[nodiscard]] looper::error stop_read() noexcept;
     [[nodiscard]] looper::error write(write_request&& request) noexcept;
+    [[nodiscard]] looper::error write_many(std::vector<write_request>&& requests) noexcept;
 
     void close() noexcept;
 
@@ -74,18 +89,31 @@ struct base_io final {
     void handle_connect(std::unique_lock<std::mutex>& lock, const loop_resource::control& control) noexcept requires connectable_io_type<t_io_, t_wr_, t_rd_>;
     void on_connect_done(std::unique_lock<std::mutex>& lock, const loop_resource::control& control, error error = error_success) noexcept requires connectable_io_type<t_io_, t_wr_, t_rd_>;
     void report_write_requests_finished(std::unique_lock<std::mutex>& lock) noexcept;
-    bool do_write() noexcept;
+    void schedule_report_write_requests(const loop_resource::control& control) noexcept;
+    bool try_write_now(write_request& request, const loop_resource::control& control) noexcept;
+    bool do_write(bool& would_block) noexcept;
+    bool do_write_batched(bool& would_block) noexcept requires batch_writable_io_type<t_io_, t_wr_>;
+    bool do_write_datagrams(bool& would_block) noexcept requires batch_datagram_io_type<t_io_, t_wr_>;
 
     const looper::handle m_handle;
     io_type m_io;
+    // in edge-triggered mode, readiness is only reported once per change, so reads and writes
+    // must continue until the socket would block.
+    const bool m_edge_triggered;
+    // owned by the loop, which outlives this object
+    const std::span<uint8_t> m_read_buffer;
 
     loop_resource m_resource;
     resource_state m_state;
 
     read_callback m_read_callback;
+    read_buffer_provider m_read_buffer_provider;
+    // a buffer given by the provider which no data was read into, used before calling the provider again
+    std::span<uint8_t> m_unused_provided_buffer;
     std::deque<write_request> m_write_requests;
     std::deque<write_request> m_completed_write_requests;
     bool m_write_pending;
+    bool m_write_report_scheduled;
     connect_callback m_connect_callback;
     bool m_connection_pending;
     bool m_connected;
@@ -100,6 +128,7 @@ public:
     using io_type = t_io_;
     using read_callback = std::function<void(looper::handle, const t_rd_&)>;
     using connector = std::function<looper::error(const io_type&)>;
+    using read_preparer = typename base::read_preparer;
 
     io(looper::handle handle, const loop_ptr& loop, t_io_&& io_obj) noexcept;
 
@@ -110,6 +139,7 @@ public:
 
     [[nodiscard]] looper::handle handle() const;
     [[nodiscard]] const io_type& io_obj() const;
+    [[nodiscard]] io_type& io_obj();
 
     [[nodiscard]] std::pair<std::unique_lock<std::mutex>, io_control> use() noexcept;
 
@@ -118,9 +148,10 @@ public:
     [[nodiscard]] looper::error mark_connected() noexcept requires connectable_io_type<t_io_, t_wr_, t_rd_>;
     [[nodiscard]] looper::error connect(connector&& connector, connect_callback&& callback) noexcept requires connectable_io_type<t_io_, t_wr_, t_rd_>;
 
-    [[nodiscard]] looper::error start_read(read_callback&& callback) noexcept;
+    [[nodiscard]] looper::error start_read(read_callback&& callback, read_buffer_provider&& provider = nullptr, read_preparer&& preparer = nullptr) noexcept;
     [[nodiscard]] looper::error stop_read() noexcept;
     [[nodiscard]] looper::error write(write_request&& request) noexcept;
+    [[nodiscard]] looper::error write_many(std::vector<write_request>&& requests) noexcept;
 
     // todo: return errors if closed in other funcs
     void close() noexcept;
@@ -139,26 +170,37 @@ template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t
 base_io<t_wr_, t_rd_, t_io_>::base_io(const looper::handle handle, const loop_ptr& loop, io_type&& io_obj) noexcept
     : m_handle(handle)
     , m_io(std::move(io_obj))
+    , m_edge_triggered(loop->options().edge_triggered_io)
+    , m_read_buffer(loop->read_buffer())
     , m_resource(loop)
     , m_state()
     , m_read_callback()
+    , m_read_buffer_provider()
+    , m_unused_provided_buffer()
     , m_write_requests()
     , m_completed_write_requests()
     , m_write_pending(false)
+    , m_write_report_scheduled(false)
     , m_connect_callback()
     , m_connection_pending(false)
     , m_connected(false)
 {}
 
 template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
-looper::error base_io<t_wr_, t_rd_, t_io_>::start_read(read_callback&& callback) noexcept {
+looper::error base_io<t_wr_, t_rd_, t_io_>::start_read(read_callback&& callback, read_buffer_provider&& provider, read_preparer&& preparer) noexcept {
     auto [lock, control] = m_resource.lock_loop();
     RETURN_IF_ERROR(m_state.verify_not_errored());
     RETURN_IF_ERROR(m_state.verify_not_reading());
 
+    if (preparer) {
+        RETURN_IF_ERROR(preparer(m_io));
+    }
+
     looper_trace_info(loop_io_log_module, "io starting read: handle=%lu", m_handle);
 
     m_read_callback = callback;
+    m_read_buffer_provider = std::move(provider);
+    m_unused_provided_buffer = {};
     control.request_events(event_type::in, events_update_type::append);
     m_state.set_reading(true);
 
@@ -188,6 +230,10 @@ looper::error base_io<t_wr_, t_rd_, t_io_>::write(write_request&& request) noexc
 
     looper_trace_info(loop_io_log_module, "writing, new request: handle=%lu, buffer_size=%lu", m_handle, request.size);
 
+    if (try_write_now(request, control)) {
+        return error_success;
+    }
+
     m_write_requests.push_back(std::move(request));
 
     if (!m_write_pending) {
@@ -198,6 +244,43 @@ looper::error base_io<t_wr_, t_rd_, t_io_>::write(write_request&& request) noexc
     return error_success;
 }
 
+template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
+looper::error base_io<t_wr_, t_rd_, t_io_>::write_many(std::vector<write_request>&& requests) noexcept {
+    auto [lock, control] = m_resource.lock_loop();
+    RETURN_IF_ERROR(m_state.verify_not_errored());
+
+    looper_trace_info(loop_io_log_module, "writing, new requests: handle=%lu, count=%lu", m_handle, requests.size());
+
+    const auto can_write_now = !m_write_pending && m_write_requests.empty() && m_state.can_write() && !m_connection_pending;
+    for (auto& request : requests) {
+        m_write_requests.push_back(std::move(request));
+    }
+
+    if (can_write_now) {
+        // like with a single request, write what is possible immediately and leave the rest to the loop
+        bool would_block = false;
+        const auto success = do_write(would_block);
+        if (!m_completed_write_requests.empty()) {
+            schedule_report_write_requests(control);
+        }
+
+        if (!success) {
+            m_state.mark_errored();
+            return error_success;
+        }
+        if (m_write_requests.empty()) {
+            return error_success;
+        }
+    }
+
+    if (!m_write_pending) {
+        control.request_events(event_type::out, events_update_type::append);
+        m_write_pending = true;
+    }
+
+    return error_success;
+}
+
 template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
 void base_io<t_wr_, t_rd_, t_io_>::close() noexcept {
     auto [lock, control] = m_resource.lock_loop();
@@ -213,21 +296,72 @@ void base_io<t_wr_, t_rd_, t_io_>::handle_read(std::unique_lock<std::mutex>& loc
         return;
     }
 
-    uint8_t read_buffer[1024]{};
-    t_rd_ read_data{};
-    read_data.buffer = std::span<uint8_t>{read_buffer, sizeof(read_buffer)};
-    const auto error = m_io.read(read_data);
-    read_data.error = error;
+    static constexpr size_t max_reads_in_one_iteration = 16;
+
+    // in level-triggered mode, read once and let the poller report again if more data remains.
+    // in edge-triggered mode, read until the socket would block, but only up to a limit so as not to starve
+    // the loop. if the limit is reached, the resource is rearmed to be reported again.
+    size_t read_count = m_edge_triggered ? max_reads_in_one_iteration : 1;
+
+    while ((read_count--) > 0) {
+        std::span<uint8_t> buffer;
+        if (!m_unused_provided_buffer.empty()) {
+            buffer = m_unused_provided_buffer;
+            m_unused_provided_buffer = {};
+        } else if (m_read_buffer_provider != nullptr) {
+            buffer = invoke_func_r<std::mutex, std::span<uint8_t>, looper::handle>(
+                lock, "io_read_buffer_provider", m_read_buffer_provider, m_handle);
+
+            if (!control.is_attached()) {
+                // closed from the provider, this object may no longer exist
+                return;
+            }
+            if (!m_state.is_reading() || m_state.is_errored()) {
+                return;
+            }
+        }
+        const bool provided = !buffer.empty();
+        if (!provided) {
+            buffer = m_read_buffer;
+        }
 
-    if (error == error_success) {
-        read_data.buffer = std::span<uint8_t>{read_buffer, read_data.read_count};
-        looper_trace_debug(loop_io_log_module, "stream read new data: handle=%lu, data_size=%lu", m_handle, read_data.buffer.size());
-    } else {
-        m_state.mark_errored();
-        looper_trace_error(loop_io_log_module, "stream read error: handle=%lu, code=%lu", m_handle, error);
+        t_rd_ read_data{};
+        read_data.buffer = buffer;
+        const auto error = m_io.read(read_data);
+        read_data.error = error;
+
+        if (error == error_again) {
+            // would block, wait for the next event. the provider's buffer was not handed to the callback,
+            // so it is kept for the next read rather than lost.
+            if (provided) {
+                m_unused_provided_buffer = buffer;
+            }
+            return;
+        }
+
+        if (error == error_success) {
+            read_data.buffer = read_data.buffer.first(read_data.read_count);
+            looper_trace_debug(loop_io_log_module, "stream read new data: handle=%lu, data_size=%lu", m_handle, read_data.buffer.size());
+        } else {
+            m_state.mark_errored();
+            looper_trace_error(loop_io_log_module, "stream read error: handle=%lu, code=%lu", m_handle, error);
+        }
+
+        invoke_func<std::mutex, looper::handle, const t_rd_&>(lock, "io_loop_callback", m_read_callback, m_handle, read_data);
+
+        if (!m_edge_triggered) {
+            return;
+        }
+        if (!control.is_attached()) {
+            // closed from the callback, this object may no longer exist
+            return;
+        }
+        if (!m_state.is_reading() || m_state.is_errored()) {
+            return;
+        }
     }
 
-    invoke_func<std::mutex, looper::handle, const t_rd_&>(lock, "io_loop_callback", m_read_callback, m_handle, read_data);
+    control.request_events(event_type::none, events_update_type::rearm);
 }
 
 template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
@@ -237,7 +371,8 @@ void base_io<t_wr_, t_rd_, t_io_>::handle_write(std::unique_lock<std::mutex>& lo
         return;
     }
 
-    if (!do_write()) {
+    bool would_block = false;
+    if (!do_write(would_block)) {
         m_state.mark_errored();
         m_write_pending = false;
         control.request_events(event_type::out, events_update_type::remove);
@@ -245,6 +380,9 @@ void base_io<t_wr_, t_rd_, t_io_>::handle_write(std::unique_lock<std::mutex>& lo
         if (m_write_requests.empty()) {
             m_write_pending = false;
             control.request_events(event_type::out, events_update_type::remove);
+        } else if (m_edge_triggered && !would_block) {
+            // stopped due to the write limit while the socket is still writable, no new edge will come for it
+            control.request_events(event_type::none, events_update_type::rearm);
         }
     }
 
@@ -295,9 +433,61 @@ void base_io<t_wr_, t_rd_, t_io_>::report_write_requests_finished(
 }
 
 template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
-bool base_io<t_wr_, t_rd_, t_io_>::do_write() noexcept {
+void base_io<t_wr_, t_rd_, t_io_>::schedule_report_write_requests(const loop_resource::control& control) noexcept {
+    if (m_write_report_scheduled) {
+        return;
+    }
+
+    m_write_report_scheduled = true;
+    control.invoke_in_loop_if_attached([this](std::unique_lock<std::mutex>& lock)->void {
+        m_write_report_scheduled = false;
+        report_write_requests_finished(lock);
+    });
+}
+
+template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
+bool base_io<t_wr_, t_rd_, t_io_>::try_write_now(write_request& request, const loop_resource::control& control) noexcept {
+    // with nothing queued, the socket is likely writable. writing immediately saves registering for write events
+    // and waiting for the loop, which is most of the cost of small writes.
+    if (m_write_pending || !m_write_requests.empty() || !m_state.can_write() || m_connection_pending) {
+        return false;
+    }
+
+    size_t written;
+    const auto error = m_io.write(request, written);
+    if (error == error_success) {
+        request.pos += written;
+        if (request.pos < request.size) {
+            // the rest is written once the socket is writable
+            return false;
+        }
+
+        looper_trace_debug(loop_io_log_module, "io write request finished inline: handle=%lu", m_handle);
+        request.error = error_success;
+    } else if (error == error_in_progress || error == error_again) {
+        return false;
+    } else {
+        looper_trace_error(loop_io_log_module, "io write request failed: handle=%lu, code=%lu", m_handle, error);
+        request.error = error;
+        m_state.mark_errored();
+    }
+
+    // callbacks are still only called from the loop, and in the order of the writes
+    m_completed_write_requests.push_back(std::move(request));
+    schedule_report_write_requests(control);
+
+    return true;
+}
+
+template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
+bool base_io<t_wr_, t_rd_, t_io_>::do_write(bool& would_block) noexcept {
+    if constexpr (batch_writable_io_type<t_io_, t_wr_>) {
+        return do_write_batched(would_block);
+    } else if constexpr (batch_datagram_io_type<t_io_, t_wr_>) {
+        return do_write_datagrams(would_block);
+    }
+
     // todo: better use of queues
-    // todo: use iovec
 
     static constexpr size_t max_writes_to_do_in_one_iteration = 16;
 
@@ -312,7 +502,8 @@ bool base_io<t_wr_, t_rd_, t_io_>::do_write() noexcept {
         if (error == error_success) {
             request.pos += written;
             if (request.pos < request.size) {
-                // didn't finish write
+                // didn't finish write, socket buffer is full
+                would_block = true;
                 return true;
             }
 
@@ -323,6 +514,7 @@ bool base_io<t_wr_, t_rd_, t_io_>::do_write() noexcept {
             m_write_requests.pop_front();
         } else if (error == error_in_progress || error == error_again) {
             // didn't finish write, but need to try again later
+            would_block = true;
             return true;
         } else {
             looper_trace_error(loop_io_log_module, "io write request failed: handle=%lu, code=%lu", m_handle, error);
@@ -338,6 +530,112 @@ bool base_io<t_wr_, t_rd_, t_io_>::do_write() noexcept {
     return true;
 }
 
+template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
+bool base_io<t_wr_, t_rd_, t_io_>::do_write_batched(bool& would_block) noexcept
+    requires batch_writable_io_type<t_io_, t_wr_> {
+    static constexpr size_t max_writes_to_do_in_one_iteration = 16;
+    static constexpr size_t max_requests_in_one_write = 1024;
+
+    // each write takes as many queued requests as possible, but still only up to 16 writes are done,
+    // so as not to starve the loop with writes
+    size_t write_count = max_writes_to_do_in_one_iteration;
+
+    while (!m_write_requests.empty() && (write_count--) > 0) {
+        const auto count = std::min(m_write_requests.size(), max_requests_in_one_write);
+        size_t requested = 0;
+        for (size_t i = 0; i < count; i++) {
+            requested += m_write_requests[i].size - m_write_requests[i].pos;
+        }
+
+        size_t written;
+        const auto error = m_io.write(m_write_requests, count, written);
+        if (error == error_in_progress || error == error_again) {
+            // didn't finish write, but need to try again later
+            would_block = true;
+            return true;
+        } else if (error != error_success) {
+            // the error belongs to the first request, as nothing was written
+            auto& request = m_write_requests.front();
+            looper_trace_error(loop_io_log_module, "io write request failed: handle=%lu, code=%lu", m_handle, error);
+            request.error = error;
+
+            m_completed_write_requests.push_back(std::move(request));
+            m_write_requests.pop_front();
+
+            return false;
+        }
+
+        // written data may end in the middle of any of the requests. requests with nothing left to write,
+        // such as empty ones, are finished even if nothing was written.
+        auto left = written;
+        while (!m_write_requests.empty()) {
+            auto& request = m_write_requests.front();
+            const auto advance = std::min(left, request.size - request.pos);
+            request.pos += advance;
+            left -= advance;
+
+            if (request.pos < request.size) {
+                break;
+            }
+
+            looper_trace_debug(loop_io_log_module, "io write request finished: handle=%lu", m_handle);
+            request.error = error_success;
+
+            m_completed_write_requests.push_back(std::move(request));
+            m_write_requests.pop_front();
+        }
+
+        if (written < requested) {
+            // socket buffer is full
+            would_block = true;
+            return true;
+        }
+    }
+
+    return true;
+}
+
+template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
+bool base_io<t_wr_, t_rd_, t_io_>::do_write_datagrams(bool& would_block) noexcept
+    requires batch_datagram_io_type<t_io_, t_wr_> {
+    static constexpr size_t max_writes_to_do_in_one_iteration = 16;
+
+    // the io may send fewer requests than given without blocking, so only a failed send is taken as blocking
+    size_t write_count = max_writes_to_do_in_one_iteration;
+
+    while (!m_write_requests.empty() && (write_count--) > 0) {
+        size_t sent;
+        const auto error = m_io.send(m_write_requests, m_write_requests.size(), sent);
+        if (error == error_in_progress || error == error_again) {
+            // didn't finish write, but need to try again later
+            would_block = true;
+            return true;
+        } else if (error != error_success) {
+            // the error belongs to the first request, as nothing was sent
+            auto& request = m_write_requests.front();
+            looper_trace_error(loop_io_log_module, "io write request failed: handle=%lu, code=%lu", m_handle, error);
+            request.error = error;
+
+            m_completed_write_requests.push_back(std::move(request));
+            m_write_requests.pop_front();
+
+            return false;
+        }
+
+        looper_trace_debug(loop_io_log_module, "io write requests finished: handle=%lu, count=%lu", m_handle, sent);
+        for (size_t i = 0; i < sent; i++) {
+            auto& request = m_write_requests.front();
+            request.pos = request.size;
+            request.error = error_success;
+
+            m_completed_write_requests.push_back(std::move(request));
+            m_write_requests.pop_front();
+        }
+    }
+
+    return true;
+}
+
 // BASE_IO ---------------------------------------------------------
 
 template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
@@ -356,6 +654,11 @@ const t_io_& io<t_wr_, t_rd_, t_io_>::io_obj() const {
     return m_base.m_io;
 }
 
+template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
+t_io_& io<t_wr_, t_rd_, t_io_>::io_obj() {
+    return m_base.m_io;
+}
+
 template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
 std::pair<std::unique_lock<std::mutex>, io_control> io<t_wr_, t_rd_, t_io_>::use() noexcept {
     auto [lock, res_control] = m_base.m_resource.lock_loop();
@@ -367,7 +670,7 @@ void io<t_wr_, t_rd_, t_io_>::register_to_loop() noexcept {
     auto [lock, control] = m_base.m_resource.lock_loop();
     control.attach_to_loop(
         m_base.m_io.get_descriptor(),
-        event_type::none,
+        m_base.m_edge_triggered ? event_type::edge : event_type::none,
         std::bind_front(&io::handle_events, this));
 }
 
@@ -421,8 +724,8 @@ looper::error io<t_wr_, t_rd_, t_io_>::connect(
 }
 
 template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
-looper::error io<t_wr_, t_rd_, t_io_>::start_read(read_callback&& callback) noexcept {
-    return m_base.start_read(std::move(callback));
+looper::error io<t_wr_, t_rd_, t_io_>::start_read(read_callback&& callback, read_buffer_provider&& provider, read_preparer&& preparer) noexcept {
+    return m_base.start_read(std::move(callback), std::move(provider), std::move(preparer));
 }
 
 template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
@@ -435,6 +738,11 @@ looper::error io<t_wr_, t_rd_, t_io_>::write(write_request&& request) noexcept {
     return m_base.write(std::move(request));
 }
 
+template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
+looper::error io<t_wr_, t_rd_, t_io_>::write_many(std::vector<write_request>&& requests) noexcept {
+    return m_base.write_many(std::move(requests));
+}
+
 template<write_request_type t_wr_, read_data_type t_rd_, io_type<t_wr_, t_rd_> t_io_>
 void io<t_wr_, t_rd_, t_io_>::close() noexcept {
     m_base.close();
@@ -452,13 +760,20 @@ void io<t_wr_, t_rd_, t_io_>::handle_events(
     }
 
     if (m_base.m_connection_pending) {
-        if ((events & event_type::out) != 0) {
-            m_base.handle_connect(lock, control);
+        if constexpr (connectable_io_type<t_io_, t_wr_, t_rd_>) {
+            if ((events & event_type::out) != 0) {
+                m_base.handle_connect(lock, control);
+            }
         }
     } else {
         if ((events & event_type::in) != 0) {
             // new data
             m_base.handle_read(lock, control);
+
+            if (!control.is_attached()) {
+                // closed during the read callback
+                return;
+            }
         }
 
         if ((events & event_type::out) != 0) {
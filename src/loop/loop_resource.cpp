@@ -29,7 +29,7 @@ bool resource_state::is_reading() const {
 }
 
 looper::error resource_state::verify_not_reading() const {
-    if (m_is_errored) {
+    if (m_is_reading) {
         return error_already_reading;
     }
 
@@ -82,6 +82,11 @@ void loop_resource::control::attach_to_loop(const os::descriptor descriptor, con
         }
 
         auto lock = loop->lock_loop();
+        if (!loop->has_resource(resource)) {
+            // removed from another thread while the loop was unlocked, the owning object may no longer exist
+            return;
+        }
+
         control control(loop, resource);
         handle_events(lock, control, events_act);
     });
@@ -94,6 +99,10 @@ void loop_resource::control::detach_from_loop() noexcept {
     }
 }
 
+bool loop_resource::control::is_attached() const noexcept {
+    return m_resource != empty_handle && m_loop->has_resource(m_resource);
+}
+
 void loop_resource::control::request_events(const event_type events, const events_update_type type) const noexcept {
     m_loop->request_resource_events(m_resource, events, type);
 }
@@ -102,6 +111,25 @@ void loop_resource::control::invoke_in_loop(loop_callback&& callback) const noex
     m_loop->invoke_from_loop(std::move(callback));
 }
 
+void loop_resource::control::invoke_in_loop_if_attached(attached_callback&& callback) const noexcept {
+    // the callback is stored in the loop itself, so holding a strong reference would keep the loop alive forever
+    std::weak_ptr<loop> weak_loop = m_loop;
+    const auto resource = m_resource;
+    m_loop->invoke_from_loop([weak_loop, resource, callback]()->void {
+        const auto loop = weak_loop.lock();
+        if (!loop) {
+            return;
+        }
+
+        auto lock = loop->lock_loop();
+        if (!loop->has_resource(resource)) {
+            return;
+        }
+
+        callback(lock);
+    });
+}
+
 loop_resource::loop_resource(loop_ptr loop)
     : m_loop(std::move(loop))
     , m_resource(empty_handle)
@@ -40,6 +40,7 @@ public:
     class control final {
     public:
         using handle_events_func = std::function<void(std::unique_lock<std::mutex>&, control&, event_type events)>;
+        using attached_callback = std::function<void(std::unique_lock<std::mutex>&)>;
 
         control(loop_ptr loop, looper::impl::resource& resource);
 
@@ -47,8 +48,14 @@ public:
 
         void attach_to_loop(os::descriptor descriptor, event_type events, handle_events_func&& handle_events) noexcept;
         void detach_from_loop() noexcept;
+        // whether the resource is still registered with the loop. callbacks invoked while the loop is unlocked
+        // may close the resource, this should be checked before using it again.
+        [[nodiscard]] bool is_attached() const noexcept;
         void request_events(event_type events, events_update_type type) const noexcept;
         void invoke_in_loop(loop_callback&& callback) const noexcept;
+        // invokes the callback from the loop, with the loop locked, only if the resource is still attached by then.
+        // this allows the callback to safely use the object owning the resource.
+        void invoke_in_loop_if_attached(attached_callback&& callback) const noexcept;
 
         template<typename... args_>
         void invoke_in_loop(const std::function<void(args_...)>& ref, args_... args) const noexcept {
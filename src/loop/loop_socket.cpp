@@ -1,4 +1,6 @@
 
+#include <algorithm>
+
 #include "loop_socket.h"
 
 
@@ -8,48 +10,168 @@ namespace looper::impl {
 
 udp_io::udp_io(os::udp&& obj) noexcept
     : m_obj(std::move(obj))
+    , m_read_mode(udp_read_mode::single)
+    , m_read_buffer()
+    , m_read_buffer_size(0)
+    , m_batch_slots()
+    , m_batch_datagrams()
 {}
 
 os::descriptor udp_io::get_descriptor() const noexcept {
     return os::get_descriptor(m_obj);
 }
 
-looper::error udp_io::read(udp_read_data& data) const noexcept {
-    char ip_buff[64]{};
-    uint16_t port;
-    const auto error = os::interface::udp::read(
+looper::error udp_io::read(udp_read_data& data) noexcept {
+    switch (m_read_mode) {
+        case udp_read_mode::batch:
+            return read_batch(data);
+        case udp_read_mode::segmented:
+            return read_segmented(data);
+        default:
+            break;
+    }
+
+    return os::interface::udp::read(
         m_obj,
         data.buffer.data(),
         data.buffer.size(),
         data.read_count,
-        ip_buff,
-        sizeof(ip_buff),
-        port);
-    if (error != error_success) {
-        return error;
-    }
-
-    data.sender = inet_address_view{std::string_view(ip_buff), port};
-    return error_success;
+        data.sender);
 }
 
 looper::error udp_io::write(const udp_write_request& request, size_t& written) const noexcept {
+    if (request.segment_size != 0) {
+        os::interface::udp::outgoing_datagram datagram{
+            request.destination,
+            request.buffer.get() + request.pos,
+            request.size - request.pos,
+            request.segment_size
+        };
+
+        // the datagrams are sent whole, or not at all
+        size_t sent;
+        RETURN_IF_ERROR(os::interface::udp::write_many(m_obj, &datagram, 1, sent));
+        written = sent > 0 ? datagram.size : 0;
+        return error_success;
+    }
+
     return os::interface::udp::write(
                 m_obj,
-                request.destination.ip,
-                request.destination.port,
+                request.destination,
                 request.buffer.get() + request.pos,
                 request.size - request.pos,
                 written);
 }
+looper::error udp_io::send(const std::deque<udp_write_request>& requests, size_t count, size_t& sent_count) const noexcept {
+    count = std::min(count, os::interface::udp::max_datagrams_in_write);
+
+    os::interface::udp::outgoing_datagram datagrams[os::interface::udp::max_datagrams_in_write];
+    for (size_t i = 0; i < count; i++) {
+        const auto& request = requests[i];
+        datagrams[i].destination = request.destination;
+        datagrams[i].buffer = request.buffer.get() + request.pos;
+        datagrams[i].size = request.size - request.pos;
+        datagrams[i].segment_size = request.segment_size;
+    }
+
+    return os::interface::udp::write_many(m_obj, datagrams, count, sent_count);
+}
+
+looper::error udp_io::enable_single_read() noexcept {
+    return reset_read_mode();
+}
+
+looper::error udp_io::enable_batch_read(size_t batch_size, size_t max_datagram_size) noexcept {
+    RETURN_IF_ERROR(reset_read_mode());
+
+    batch_size = std::clamp<size_t>(batch_size, 1, os::interface::udp::max_datagrams_in_read);
+    max_datagram_size = std::max<size_t>(max_datagram_size, 1);
+
+    m_read_buffer_size = batch_size * max_datagram_size;
+    m_read_buffer.reset(new uint8_t[m_read_buffer_size]);
+    m_batch_slots.resize(batch_size);
+    for (size_t i = 0; i < batch_size; i++) {
+        auto& slot = m_batch_slots[i];
+        slot.buffer = m_read_buffer.get() + i * max_datagram_size;
+        slot.buffer_size = max_datagram_size;
+    }
+
+    m_batch_datagrams.reserve(batch_size);
+    m_read_mode = udp_read_mode::batch;
+
+    return error_success;
+}
+
+looper::error udp_io::enable_segmented_read(const size_t max_read_size) noexcept {
+    RETURN_IF_ERROR(reset_read_mode());
+    RETURN_IF_ERROR(os::interface::udp::set_receive_coalescing(m_obj, true));
+
+    // coalesced reads may be larger than the loop's read buffer, so they get their own
+    m_read_buffer_size = std::clamp<size_t>(max_read_size, 1, os::interface::udp::max_segmented_read_size);
+    m_read_buffer.reset(new uint8_t[m_read_buffer_size]);
+    m_read_mode = udp_read_mode::segmented;
+
+    return error_success;
+}
 
 void udp_io::close() noexcept {
     m_obj.close();
 }
 
+looper::error udp_io::reset_read_mode() noexcept {
+    if (m_read_mode == udp_read_mode::segmented) {
+        RETURN_IF_ERROR(os::interface::udp::set_receive_coalescing(m_obj, false));
+    }
+
+    m_read_mode = udp_read_mode::single;
+    m_read_buffer.reset();
+    m_read_buffer_size = 0;
+    m_batch_slots.clear();
+    m_batch_datagrams.clear();
+
+    return error_success;
+}
+
+looper::error udp_io::read_batch(udp_read_data& data) noexcept {
+    size_t count;
+    RETURN_IF_ERROR(os::interface::udp::read_many(m_obj, m_batch_slots.data(), m_batch_slots.size(), count));
+
+    m_batch_datagrams.clear();
+    for (size_t i = 0; i < count; i++) {
+        const auto& slot = m_batch_slots[i];
+        m_batch_datagrams.push_back(udp_datagram{
+            slot.sender,
+            std::span<const uint8_t>{slot.buffer, slot.size}
+        });
+    }
+
+    data.read_count = count;
+    data.datagrams = m_batch_datagrams;
+    return error_success;
+}
+
+looper::error udp_io::read_segmented(udp_read_data& data) noexcept {
+    RETURN_IF_ERROR(os::interface::udp::read_segmented(
+        m_obj,
+        m_read_buffer.get(),
+        m_read_buffer_size,
+        data.read_count,
+        data.segment_size,
+        data.sender));
+
+    data.buffer = std::span<uint8_t>{m_read_buffer.get(), m_read_buffer_size};
+    return error_success;
+}
+
 udp_socket::udp_socket(const looper::handle handle, const loop_ptr& loop, udp_io&& obj) noexcept
-    : m_io(io_type(handle, loop, std::move(obj)))
-{}
+    : m_io(io_type(handle, loop, std::move(obj))) {
+    m_io.register_to_loop();
+
+    // udp is connectionless, so the socket is usable immediately
+    auto [lock, control] = m_io.use();
+    control.state.set_read_enabled(true);
+    control.state.set_write_enabled(true);
+}
 
 looper::error udp_socket::bind(const uint16_t port) noexcept {
     auto [lock, control] = m_io.use();
@@ -65,9 +187,40 @@ looper::error udp_socket::bind(const std::string_view address, const uint16_t po
     return os::ipv4_bind(m_io.io_obj().m_obj, address, port);
 }
 
-looper::error udp_socket::start_read(udp_read_callback&& callback) noexcept {
+looper::error udp_socket::start_read(udp_read_callback&& callback, read_buffer_provider&& provider) noexcept {
+    // only this callback wants the sender as a string, so the formatting is done here
+    return start_read([callback](const looper::udp udp, const inet_endpoint sender, const std::span<const uint8_t> buffer, const looper::error error)->void {
+        char ip_buff[os::interface::inet::ip_buffer_size]{};
+        if (error == error_success) {
+            os::interface::inet::format_ip(sender, ip_buff, sizeof(ip_buff));
+        }
+
+        callback(udp, inet_address_view{std::string_view(ip_buff), sender.port}, buffer, error);
+    }, std::move(provider));
+}
+
+looper::error udp_socket::start_read(udp_endpoint_read_callback&& callback, read_buffer_provider&& provider) noexcept {
+    // the read mode may only change while not reading, so it is changed as part of starting the read
     return m_io.start_read([callback](const looper::handle handle, const udp_read_data& data)->void {
         callback(handle, data.sender, data.buffer, data.error);
+    }, std::move(provider), [](udp_io& io)->looper::error {
+        return io.enable_single_read();
+    });
+}
+
+looper::error udp_socket::start_read_batch(udp_batch_read_callback&& callback, const size_t batch_size, const size_t max_datagram_size) noexcept {
+    return m_io.start_read([callback](const looper::handle handle, const udp_read_data& data)->void {
+        callback(handle, data.datagrams, data.error);
+    }, nullptr, [batch_size, max_datagram_size](udp_io& io)->looper::error {
+        return io.enable_batch_read(batch_size, max_datagram_size);
+    });
+}
+
+looper::error udp_socket::start_read_segmented(udp_segmented_read_callback&& callback, const size_t max_read_size) noexcept {
+    return m_io.start_read([callback](const looper::handle handle, const udp_read_data& data)->void {
+        callback(handle, data.sender, data.buffer, data.segment_size, data.error);
+    }, nullptr, [max_read_size](udp_io& io)->looper::error {
+        return io.enable_segmented_read(max_read_size);
     });
 }
 
@@ -79,6 +232,10 @@ looper::error udp_socket::write(udp_write_request&& request) noexcept {
     return m_io.write(std::move(request));
 }
 
+looper::error udp_socket::write_many(std::vector<udp_write_request>&& requests) noexcept {
+    return m_io.write_many(std::move(requests));
+}
+
 void udp_socket::close() noexcept {
     m_io.close();
 }
@@ -1,12 +1,15 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "os/os.h"
 #include "loop_io.h"
 
 namespace looper::impl {
 
 struct stream_write_request {
-    std::unique_ptr<uint8_t[]> buffer;
+    shared_buffer buffer;
     size_t pos;
     size_t size;
     looper::write_callback write_callback;
@@ -30,10 +33,13 @@ struct stream_io {
 
     [[nodiscard]] looper::error read(stream_read_data& data) noexcept;
     [[nodiscard]] looper::error write(const stream_write_request& request, size_t& written) noexcept;
+    [[nodiscard]] looper::error write(const std::deque<stream_write_request>& requests, size_t count, size_t& written) noexcept;
     [[nodiscard]] looper::error finalize_connect() noexcept;
     void close() noexcept;
 
     t_ m_obj;
+    // reused between batched writes to avoid allocating for each
+    std::vector<os::io_buffer> m_write_buffers;
 };
 
 struct udp_write_request {
@@ -42,29 +48,60 @@ struct udp_write_request {
     looper::error error;
     looper::write_callback write_callback;
 
-    std::unique_ptr<uint8_t[]> buffer;
-    inet_address destination;
+    shared_buffer buffer;
+    inet_endpoint destination;
+    // if not 0, the buffer is sent as several datagrams of this size
+    size_t segment_size;
 };
 
 struct udp_read_data {
     std::span<uint8_t> buffer;
+    // in batch mode, the amount of datagrams received
     size_t read_count;
-    inet_address sender;
+    inet_endpoint sender;
+    std::span<const udp_datagram> datagrams;
+    // in segmented mode, the size of each of the datagrams in the buffer
+    size_t segment_size;
     looper::error error;
 };
 
+enum class udp_read_mode {
+    single,
+    batch,
+    segmented
+};
+
 struct udp_io {
     using underlying_type = os::udp;
 
     udp_io(os::udp&& obj) noexcept;
 
     [[nodiscard]] os::descriptor get_descriptor() const noexcept;
-    [[nodiscard]] looper::error read(udp_read_data& data) const noexcept;
+    [[nodiscard]] looper::error read(udp_read_data& data) noexcept;
     [[nodiscard]] looper::error write(const udp_write_request& request, size_t& written) const noexcept;
+    [[nodiscard]] looper::error send(const std::deque<udp_write_request>& requests, size_t count, size_t& sent_count) const noexcept;
+
+    // reads will receive a single datagram into the buffer given with the read
+    [[nodiscard]] looper::error enable_single_read() noexcept;
+    // reads will receive up to batch_size datagrams together into space owned by this object
+    [[nodiscard]] looper::error enable_batch_read(size_t batch_size, size_t max_datagram_size) noexcept;
+    // reads will receive datagrams coalesced by the os into space owned by this object
+    [[nodiscard]] looper::error enable_segmented_read(size_t max_read_size) noexcept;
 
     void close() noexcept;
 
     os::udp m_obj;
+
+private:
+    [[nodiscard]] looper::error reset_read_mode() noexcept;
+    [[nodiscard]] looper::error read_batch(udp_read_data& data) noexcept;
+    [[nodiscard]] looper::error read_segmented(udp_read_data& data) noexcept;
+
+    udp_read_mode m_read_mode;
+    std::unique_ptr<uint8_t[]> m_read_buffer;
+    size_t m_read_buffer_size;
+    std::vector<os::interface::udp::datagram> m_batch_slots;
+    std::vector<udp_datagram> m_batch_datagrams;
 };
 
 template<os::os_stream_type t_, typename bind_func_, typename connect_func_>
@@ -79,7 +116,7 @@ public:
     template<typename... args_>
     [[nodiscard]] looper::error connect(connect_callback&& callback, args_... args) noexcept;
 
-    [[nodiscard]] looper::error start_read(looper::read_callback&& callback) noexcept;
+    [[nodiscard]] looper::error start_read(looper::read_callback&& callback, read_buffer_provider&& provider = nullptr) noexcept;
     [[nodiscard]] looper::error stop_read() noexcept;
     [[nodiscard]] looper::error write(stream_write_request&& request) noexcept;
 
@@ -121,9 +158,13 @@ public:
     [[nodiscard]] looper::error bind(uint16_t port) noexcept;
     [[nodiscard]] looper::error bind(std::string_view address, uint16_t port) noexcept;
 
-    [[nodiscard]] looper::error start_read(udp_read_callback&& callback) noexcept;
+    [[nodiscard]] looper::error start_read(udp_read_callback&& callback, read_buffer_provider&& provider = nullptr) noexcept;
+    [[nodiscard]] looper::error start_read(udp_endpoint_read_callback&& callback, read_buffer_provider&& provider = nullptr) noexcept;
+    [[nodiscard]] looper::error start_read_batch(udp_batch_read_callback&& callback, size_t batch_size, size_t max_datagram_size) noexcept;
+    [[nodiscard]] looper::error start_read_segmented(udp_segmented_read_callback&& callback, size_t max_read_size) noexcept;
     [[nodiscard]] looper::error stop_read() noexcept;
     [[nodiscard]] looper::error write(udp_write_request&& request) noexcept;
+    [[nodiscard]] looper::error write_many(std::vector<udp_write_request>&& requests) noexcept;
 
     void close() noexcept;
 
@@ -134,6 +175,7 @@ private:
 template<os::os_stream_type t_>
 stream_io<t_>::stream_io(t_&& obj) noexcept
     : m_obj(std::move(obj))
+    , m_write_buffers()
 {}
 
 template<os::os_stream_type t_>
@@ -150,10 +192,21 @@ template<os::os_stream_type t_>
 looper::error stream_io<t_>::write(const stream_write_request& request, size_t& written) noexcept {
     return os::detail::os_stream<t_>::write(
         m_obj,
-        std::span<uint8_t>{ request.buffer.get() + request.pos, request.size - request.pos },
+        std::span<const uint8_t>{ request.buffer.get() + request.pos, request.size - request.pos },
         written);
 }
 
+template<os::os_stream_type t_>
+looper::error stream_io<t_>::write(const std::deque<stream_write_request>& requests, const size_t count, size_t& written) noexcept {
+    m_write_buffers.clear();
+    for (size_t i = 0; i < count; i++) {
+        const auto& request = requests[i];
+        m_write_buffers.emplace_back(request.buffer.get() + request.pos, request.size - request.pos);
+    }
+
+    return os::stream_writev(m_obj, std::span<const os::io_buffer>{m_write_buffers}, written);
+}
+
 template<os::os_stream_type t_>
 looper::error stream_io<t_>::finalize_connect() noexcept {
     return os::detail::os_socket<t_>::finalize_connect(m_obj);
@@ -192,10 +245,10 @@ looper::error stream_socket_client<t_, bind_func_, connect_func_>::connect(conne
 }
 
 template<os::os_stream_type t_, typename bind_func_, typename connect_func_>
-looper::error stream_socket_client<t_, bind_func_, connect_func_>::start_read(looper::read_callback&& callback) noexcept {
+looper::error stream_socket_client<t_, bind_func_, connect_func_>::start_read(looper::read_callback&& callback, read_buffer_provider&& provider) noexcept {
     return m_io.start_read([callback](const looper::handle handle, const stream_read_data& data)->void {
         callback(handle, data.buffer, data.error);
-    });
+    }, std::move(provider));
 }
 
 template<os::os_stream_type t_, typename bind_func_, typename connect_func_>
@@ -5,19 +5,26 @@ namespace looper::impl {
 
 #define log_module loop_log_module "_timer"
 
-timer::timer(const looper::timer handle, loop_ptr loop, timer_callback&& callback, const std::chrono::milliseconds timeout) noexcept
+timer::timer(const looper::timer handle, loop_ptr loop, timer_callback&& callback, const std::chrono::nanoseconds timeout, const timer_mode mode, const std::chrono::nanoseconds slack) noexcept
     : m_handle(handle)
     , m_loop(std::move(loop))
     , m_running(false)
     , m_timeout(timeout)
+    , m_mode(mode)
+    , m_slack(slack)
     , m_callback(std::move(callback))
     , m_loop_data()
 {}
 
+timer::~timer() noexcept {
+    auto lock = m_loop->lock_loop();
+    m_loop->remove_timer(&m_loop_data);
+}
+
 looper::error timer::start() noexcept {
     auto lock = m_loop->lock_loop();
 
-    if (m_timeout < min_poll_timeout) {
+    if (m_timeout.count() < 1) {
         return error_timeout_too_small;
     }
 
@@ -26,7 +33,8 @@ looper::error timer::start() noexcept {
     }
 
     m_loop_data.timeout = m_timeout;
-    m_loop_data.hit = false;
+    m_loop_data.mode = m_mode;
+    m_loop_data.slack = m_slack;
     m_loop_data.next_timestamp = time_now() + m_timeout;
     m_loop_data.callback = [this]()->void {
         handle_events();
@@ -37,9 +45,6 @@ looper::error timer::start() noexcept {
 
     looper_trace_info(log_module, "starting timer: handle=%lu, next_time=%lu", m_handle, m_loop_data.next_timestamp.count());
 
-    m_loop->set_timeout_if_smaller(m_timeout);
-    m_loop->signal_run();
-
     return error_success;
 }
 
@@ -54,8 +59,6 @@ void timer::stop() noexcept {
 
     m_loop->remove_timer(&m_loop_data);
     m_running = false;
-
-    m_loop->reset_smallest_timeout();
 }
 
 void timer::reset() noexcept {
@@ -64,8 +67,8 @@ void timer::reset() noexcept {
         return;
     }
 
-    m_loop_data.hit = false;
     m_loop_data.next_timestamp = time_now() + m_timeout;
+    m_loop->add_timer(&m_loop_data);
 
     looper_trace_info(log_module, "resetting timer: handle=%lu, next_time=%lu", m_handle, m_loop_data.next_timestamp.count());
 }
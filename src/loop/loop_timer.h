@@ -6,7 +6,8 @@ namespace looper::impl {
 
 class timer final {
 public:
-    timer(looper::timer handle, loop_ptr loop, timer_callback&& callback, std::chrono::milliseconds timeout) noexcept;
+    timer(looper::timer handle, loop_ptr loop, timer_callback&& callback, std::chrono::nanoseconds timeout, timer_mode mode, std::chrono::nanoseconds slack) noexcept;
+    ~timer() noexcept;
 
     [[nodiscard]] looper::error start() noexcept;
     void stop() noexcept;
@@ -19,7 +20,9 @@ private:
     loop_ptr m_loop;
 
     bool m_running;
-    std::chrono::milliseconds m_timeout;
+    std::chrono::nanoseconds m_timeout;
+    timer_mode m_mode;
+    std::chrono::nanoseconds m_slack;
     timer_callback m_callback;
 
     timer_data m_loop_data;
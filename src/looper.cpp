@@ -1,3 +1,5 @@
+#include <condition_variable>
+
 #include "looper_base.h"
 
 namespace looper {
@@ -8,23 +10,26 @@ static void run_loop(const loop loop, const std::chrono::milliseconds time = no_
     const auto end_time = impl::time_now() + time;
 
     while (true) {
-        std::unique_lock lock(get_global_loop_data().mutex);
-        auto data_opt = try_get_loop(loop);
+        auto [lock, data_opt] = try_lock_loop(loop);
         if (!data_opt) {
             break;
         }
 
+        // an idle loop waits for events with no timeout, so the wait is bounded by the time left to run
+        auto max_timeout = impl::infinite_poll_timeout;
         if (time > no_timeout) {
             const auto now = impl::time_now();
             if (now >= end_time) {
                 break;
             }
+
+            max_timeout = std::chrono::ceil<std::chrono::milliseconds>(end_time - now);
         }
 
         const auto* data = data_opt.value();
         lock.unlock();
 
-        const auto finished = data->loop->run_once();
+        const auto finished = data->loop->run_once(max_timeout);
         if (finished) {
             break;
         }
@@ -35,46 +40,46 @@ static void thread_main(const loop loop) {
     run_loop(loop);
 }
 
-static future create_future_internal(const loop loop, future_callback&& callback) {
-    auto& data = get_loop(loop);
-
+static future create_future_internal(loop_data& data, future_callback&& callback) {
     auto [handle, future_impl] = data.futures.allocate_new(
         data.loop, std::move(callback));
-    looper_trace_info(log_module, "creating future: loop=%lu, handle=%lu", loop, handle);
+    looper_trace_info(log_module, "creating future: loop=%lu, handle=%lu", data.handle, handle);
     data.futures.assign(handle, std::move(future_impl));
 
     return handle;
 }
 
-static void destroy_future_internal(const future future) {
-    auto& data = get_loop_from_handle(future);
-
+static void destroy_future_internal(loop_data& data, const future future) {
     looper_trace_info(log_module, "destroying future: loop=%lu, handle=%lu", data.handle, future);
 
     const auto future_impl = data.futures.release(future);
 }
 
-static void execute_future_internal(const future future, const std::chrono::milliseconds delay) {
-    auto& data = get_loop_from_handle(future);
-
+static void execute_future_internal(loop_data& data, const future future, const std::chrono::milliseconds delay) {
     looper_trace_info(log_module, "requesting future execution: loop=%lu, handle=%lu, delay=%lu", data.handle, future, delay.count());
 
     auto& future_impl = data.futures[future];
     throw_if_error(future_impl.execute(delay));
 }
 
-static bool wait_for_future_internal(std::unique_lock<std::mutex>& lock, const future future, const std::chrono::milliseconds timeout) {
-    auto& data = get_loop_from_handle(future);
-
+static bool wait_for_future_internal(std::unique_lock<std::mutex>& lock, loop_data& data, const future future, const std::chrono::milliseconds timeout) {
     auto& future_impl = data.futures[future];
     return future_impl.wait_for(lock, timeout);
 }
 
-loop create() {
+static void post_internal(const loop_data& data, loop_callback&& callback) {
+    looper_trace_debug(log_module, "posting callback: loop=%lu", data.handle);
+
+    data.loop->invoke_from_loop([loop = data.handle, callback = std::move(callback)]()->void {
+        invoke_func_nolock("loop_post_callback", callback, loop);
+    });
+}
+
+loop create(const loop_options& options) {
     std::unique_lock lock(get_global_loop_data().mutex);
 
-    auto [handle, data] = get_global_loop_data().loops.allocate_new();
-    get_global_loop_data().loops.assign(handle, std::move(data));
+    auto [handle, data] = get_global_loop_data().loops.assign_new(options);
+    attach_loop(handle, &data);
 
     looper_trace_info(log_module, "created new loop: handle=%lu", handle);
 
@@ -82,13 +87,14 @@ loop create() {
 }
 
 void destroy(const loop loop) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-    auto& data = get_loop(loop);
+    auto [lock, data] = lock_loop(loop);
     data.closing = true;
 
     looper_trace_info(log_module, "destroying loop: handle=%lu", loop);
 
     const auto thread = std::move(data.thread);
+    // the loop may be waiting for events with no timeout, so it is woken to see it is closing
+    data.loop->signal_run();
     lock.unlock();
 
     if (thread && thread->joinable()) {
@@ -97,24 +103,22 @@ void destroy(const loop loop) {
     }
 
     data.clear_context();
-    lock.lock();
+    detach_loop(loop);
 
+    std::unique_lock global_lock(get_global_loop_data().mutex);
     get_global_loop_data().loops.release(loop);
 
     looper_trace_info(log_module, "loop destroyed: handle=%lu", loop);
 }
 
 loop get_parent_loop(const handle handle) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-    const auto& data = get_loop_from_handle(handle);
+    auto [lock, data] = lock_loop_from_handle(handle);
 
     return data.handle;
 }
 
 void run_once(const loop loop) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    const auto& data = get_loop(loop);
+    auto [lock, data] = lock_loop(loop);
     if (data.thread) {
         throw std::runtime_error("loop running in thread");
     }
@@ -126,9 +130,7 @@ void run_once(const loop loop) {
 }
 
 void run_for(const loop loop, const std::chrono::milliseconds time) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    const auto& data = get_loop(loop);
+    auto [lock, data] = lock_loop(loop);
     if (data.thread) {
         throw std::runtime_error("loop running in thread");
     }
@@ -140,9 +142,7 @@ void run_for(const loop loop, const std::chrono::milliseconds time) {
 }
 
 void run_forever(const loop loop) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    const auto& data = get_loop(loop);
+    auto [lock, data] = lock_loop(loop);
     if (data.thread) {
         throw std::runtime_error("loop running in thread");
     }
@@ -154,9 +154,7 @@ void run_forever(const loop loop) {
 }
 
 void exec_in_thread(loop loop) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop(loop);
+    auto [lock, data] = lock_loop(loop);
     if (data.thread) {
         looper_trace_debug(log_module, "loop already running in thread: handle=%lu", loop);
         return;
@@ -167,56 +165,86 @@ void exec_in_thread(loop loop) {
     data.thread = std::make_unique<std::thread>(&thread_main, loop);
 }
 
+loop_stats get_loop_stats(const loop loop) {
+    auto [lock, data] = lock_loop(loop);
+    auto loop_lock = data.loop->lock_loop();
+    return data.loop->stats();
+}
+
 future create_future(const loop loop, future_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-    return create_future_internal(loop, std::move(callback));
+    auto [lock, data] = lock_loop(loop);
+    return create_future_internal(data, std::move(callback));
 }
 
 void destroy_future(const future future) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-    destroy_future_internal(future);
+    auto [lock, data] = lock_loop_from_handle(future);
+    destroy_future_internal(data, future);
 }
 
 void execute_once(const future future, const std::chrono::milliseconds delay) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-    execute_future_internal(future, delay);
+    auto [lock, data] = lock_loop_from_handle(future);
+    execute_future_internal(data, future, delay);
 }
 
 bool wait_for(const future future, const std::chrono::milliseconds timeout) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-    return wait_for_future_internal(lock, future, timeout);
+    auto [lock, data] = lock_loop_from_handle(future);
+    return wait_for_future_internal(lock, data, future, timeout);
 }
 
 void execute_later(const loop loop, loop_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
+    auto [lock, data] = lock_loop(loop);
+    post_internal(data, std::move(callback));
+}
 
-    const auto future = create_future_internal(loop, [callback](const looper::future future_cb)->void {
-        std::unique_lock lock_cb(get_global_loop_data().mutex);
-        destroy_future_internal(future_cb);
+bool execute_later_and_wait(const loop loop, loop_callback&& callback, const std::chrono::milliseconds timeout) {
+    // shared with the posted callback, as it still runs if the wait times out
+    struct wait_state {
+        std::mutex mutex;
+        std::condition_variable finished_cv;
+        bool finished = false;
+    };
+    const auto state = std::make_shared<wait_state>();
+
+    {
+        auto [lock, data] = lock_loop(loop);
+        post_internal(data, [state, callback = std::move(callback)](const looper::loop loop_cb)->void {
+            invoke_func_nolock("loop_wait_callback", callback, loop_cb);
+
+            std::unique_lock lock_state(state->mutex);
+            state->finished = true;
+            state->finished_cv.notify_all();
+        });
+    }
 
-        invoke_func(lock_cb, "future_singleuse_callback", callback, future_cb);
-    });
-    execute_future_internal(future, no_delay);
+    std::unique_lock lock_state(state->mutex);
+    const auto finished = [&state]()->bool { return state->finished; };
+    if (timeout == no_timeout) {
+        state->finished_cv.wait(lock_state, finished);
+        return false;
+    }
+
+    return !state->finished_cv.wait_for(lock_state, timeout, finished);
 }
 
-bool execute_later_and_wait(const loop loop, loop_callback&& callback, const std::chrono::milliseconds timeout) {
-    std::unique_lock lock(get_global_loop_data().mutex);
+void post(const loop loop, loop_callback&& callback) {
+    auto [lock, data] = lock_loop(loop);
+    post_internal(data, std::move(callback));
+}
 
-    const auto future = create_future_internal(loop, [callback](const looper::future future_cb)->void {
-        std::unique_lock lock_cb(get_global_loop_data().mutex);
-        destroy_future_internal(future_cb);
+void post_at(const loop loop, const std::chrono::steady_clock::time_point deadline, loop_callback&& callback) {
+    auto [lock, data] = lock_loop(loop);
+    auto loop_lock = data.loop->lock_loop();
 
-        invoke_func(lock_cb, "future_singleuse_callback", callback, future_cb);
-    });
-    execute_future_internal(future, no_delay);
+    const auto deadline_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch());
+    looper_trace_debug(log_module, "posting callback: loop=%lu, deadline=%lu", loop, deadline_ns.count());
 
-    return wait_for_future_internal(lock, future, timeout);
+    data.loop->invoke_from_loop_at(deadline_ns, [loop, callback = std::move(callback)]()->void {
+        invoke_func_nolock("loop_post_callback", callback, loop);
+    });
 }
 
 event create_event(const loop loop, event_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop(loop);
+    auto [lock, data] = lock_loop(loop);
 
     auto obj = os::event::create();
     auto [handle, event_data] = data.events.allocate_new(data.loop, std::move(obj), std::move(callback));
@@ -227,9 +255,7 @@ event create_event(const loop loop, event_callback&& callback) {
 }
 
 void destroy_event(const event event) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(event);
+    auto [lock, data] = lock_loop_from_handle(event);
 
     looper_trace_info(log_module, "destroying event: loop=%lu, handle=%lu", data.handle, event);
 
@@ -237,9 +263,7 @@ void destroy_event(const event event) {
 }
 
 void set_event(const event event) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(event);
+    auto [lock, data] = lock_loop_from_handle(event);
 
     looper_trace_debug(log_module, "setting event: loop=%lu, handle=%lu", data.handle, event);
 
@@ -248,9 +272,7 @@ void set_event(const event event) {
 }
 
 void clear_event(const event event) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(event);
+    auto [lock, data] = lock_loop_from_handle(event);
 
     looper_trace_debug(log_module, "clearing event: loop=%lu, handle=%lu", data.handle, event);
 
@@ -258,21 +280,23 @@ void clear_event(const event event) {
     throw_if_error(event_impl.clear());
 }
 
-timer create_timer(const loop loop, std::chrono::milliseconds timeout, timer_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
+timer create_timer(const loop loop, const std::chrono::nanoseconds timeout, timer_callback&& callback, const timer_mode mode,
+                   const std::chrono::nanoseconds slack) {
+    if (slack.count() < 0) {
+        throw_if_error(error_invalid_argument);
+    }
 
-    auto& data = get_loop(loop);
+    auto [lock, data] = lock_loop(loop);
 
-    auto [handle, timer_impl] = data.timers.assign_new(data.loop, std::move(callback), timeout);
-    looper_trace_info(log_module, "creating new timer: loop=%lu, handle=%lu, timeout=%lu", data.handle, handle, timeout.count());
+    auto [handle, timer_impl] = data.timers.assign_new(data.loop, std::move(callback), timeout, mode, slack);
+    looper_trace_info(log_module, "creating new timer: loop=%lu, handle=%lu, timeout=%lu, mode=%d, slack=%lu",
+                      data.handle, handle, timeout.count(), static_cast<int>(mode), slack.count());
 
     return handle;
 }
 
 void destroy_timer(const timer timer) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(timer);
+    auto [lock, data] = lock_loop_from_handle(timer);
 
     looper_trace_info(log_module, "destroying timer: loop=%lu, handle=%lu", data.handle, timer);
 
@@ -281,9 +305,7 @@ void destroy_timer(const timer timer) {
 }
 
 void start_timer(const timer timer) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(timer);
+    auto [lock, data] = lock_loop_from_handle(timer);
 
     looper_trace_debug(log_module, "starting timer: loop=%lu, handle=%lu", data.handle, timer);
 
@@ -292,9 +314,7 @@ void start_timer(const timer timer) {
 }
 
 void stop_timer(const timer timer) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(timer);
+    auto [lock, data] = lock_loop_from_handle(timer);
 
     looper_trace_debug(log_module, "stopping timer: loop=%lu, handle=%lu", data.handle, timer);
 
@@ -303,9 +323,7 @@ void stop_timer(const timer timer) {
 }
 
 void reset_timer(const timer timer) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(timer);
+    auto [lock, data] = lock_loop_from_handle(timer);
 
     looper_trace_debug(log_module, "resetting timer: loop=%lu, handle=%lu", data.handle, timer);
 
@@ -4,20 +4,20 @@
 
 namespace looper {
 
-loop_data::loop_data(const looper::loop handle)
+loop_data::loop_data(const looper::loop handle, const loop_options& options)
     : handle(handle)
-    , loop(std::make_shared<impl::loop>(handle))
+    , loop(std::make_shared<impl::loop>(handle, options))
     , closing(false)
     , thread(nullptr)
-    , events(handles::handle{handle}.index(), handles::type_event)
-    , timers(handles::handle{handle}.index(), handles::type_timer)
-    , futures(handles::handle{handle}.index(), handles::type_future)
-    , tcps(handles::handle{handle}.index(), handles::type_tcp)
-    , tcp_servers(handles::handle{handle}.index(), handles::type_tcp_server)
-    , udps(handles::handle{handle}.index(), handles::type_udp)
+    , events(handles::handle{handle}.index(), handles::type_event, handles::handle{handle}.generation())
+    , timers(handles::handle{handle}.index(), handles::type_timer, handles::handle{handle}.generation())
+    , futures(handles::handle{handle}.index(), handles::type_future, handles::handle{handle}.generation())
+    , tcps(handles::handle{handle}.index(), handles::type_tcp, handles::handle{handle}.generation())
+    , tcp_servers(handles::handle{handle}.index(), handles::type_tcp_server, handles::handle{handle}.generation())
+    , udps(handles::handle{handle}.index(), handles::type_udp, handles::handle{handle}.generation())
 #ifdef LOOPER_UNIX_SOCKETS
-    , unix_sockets(handles::handle{handle}.index(), handles::type_unix_socket)
-    , unix_socket_servers(handles::handle{handle}.index(), handles::type_unix_socket_server)
+    , unix_sockets(handles::handle{handle}.index(), handles::type_unix_socket, handles::handle{handle}.generation())
+    , unix_socket_servers(handles::handle{handle}.index(), handles::type_unix_socket_server, handles::handle{handle}.generation())
 #endif
 {}
 
@@ -41,9 +41,16 @@ void loop_data::clear_context() {
     loop.reset();
 }
 
+loop_slot::loop_slot()
+    : mutex()
+    , handle(empty_handle)
+    , data(nullptr)
+{}
+
 looper_data::looper_data()
     : mutex()
     , loops(0, handles::type_loop)
+    , slots()
 {}
 
 looper_data& get_global_loop_data() {
@@ -51,26 +58,54 @@ looper_data& get_global_loop_data() {
     return g_instance;
 }
 
-std::optional<loop_data*> try_get_loop(const loop loop) {
-    if (!get_global_loop_data().loops.has(loop)) {
-        return std::nullopt;
+static loop_slot& get_loop_slot(const loop loop) {
+    const handles::handle handle(loop);
+    if (loop == empty_handle || handle.type() != handles::type_loop || handle.index() >= loops_count) {
+        throw bad_handle_exception(loop);
     }
 
-    auto& data = get_global_loop_data().loops[loop];
-    if (data.closing) {
-        return std::nullopt;
+    return get_global_loop_data().slots[handle.index()];
+}
+
+void attach_loop(const loop loop, loop_data* data) {
+    auto& slot = get_loop_slot(loop);
+    std::unique_lock lock(slot.mutex);
+
+    slot.handle = loop;
+    slot.data = data;
+}
+
+void detach_loop(const loop loop) {
+    auto& slot = get_loop_slot(loop);
+    std::unique_lock lock(slot.mutex);
+
+    slot.handle = empty_handle;
+    slot.data = nullptr;
+}
+
+std::pair<loop_lock, std::optional<loop_data*>> try_lock_loop(const loop loop) {
+    auto& slot = get_loop_slot(loop);
+    std::unique_lock lock(slot.mutex);
+
+    if (slot.data == nullptr || slot.handle != loop || slot.data->closing) {
+        return {std::move(lock), std::nullopt};
     }
 
-    return {&data};
+    return {std::move(lock), slot.data};
 }
 
-loop_data& get_loop(const loop loop) {
-    auto& data = get_global_loop_data().loops[loop];
-    if (data.closing) {
+std::pair<loop_lock, loop_data&> lock_loop(const loop loop) {
+    auto& slot = get_loop_slot(loop);
+    std::unique_lock lock(slot.mutex);
+
+    if (slot.data == nullptr || slot.handle != loop) {
+        throw no_such_handle_exception(loop);
+    }
+    if (slot.data->closing) {
         throw loop_closing_exception(loop);
     }
 
-    return data;
+    return {std::move(lock), *slot.data};
 }
 
 loop get_loop_handle(const handle handle) {
@@ -79,9 +114,21 @@ loop get_loop_handle(const handle handle) {
     return loop.raw();
 }
 
-loop_data& get_loop_from_handle(const handle handle) {
-    const auto loop_handle = get_loop_handle(handle);
-    return get_loop(loop_handle);
+std::pair<loop_lock, loop_data&> lock_loop_from_handle(const handle handle) {
+    // handles of loop objects only hold the index of their loop and the low bits of its generation,
+    // so the slot is matched by those. the handle tables of the loop verify the rest.
+    auto& slot = get_loop_slot(get_loop_handle(handle));
+    std::unique_lock lock(slot.mutex);
+
+    const auto loop_generation = handles::handle{slot.handle}.generation() & handles::handle_parent_generation_mask;
+    if (slot.data == nullptr || handles::handle{handle}.parent_generation() != loop_generation) {
+        throw no_such_handle_exception(handle);
+    }
+    if (slot.data->closing) {
+        throw loop_closing_exception(slot.handle);
+    }
+
+    return {std::move(lock), *slot.data};
 }
 
 }
@@ -16,11 +16,13 @@ namespace looper {
 
 #define looper_log_module "looper"
 
-static constexpr size_t handle_counts_per_type = 64;
-static constexpr size_t loops_count = 8;
+// handle tables grow as needed, so these are only upper limits
+static constexpr size_t handle_counts_per_type = 1 << 20;
+static constexpr size_t loops_count = 64;
+static_assert(loops_count <= handles::max_handle_parent + 1);
 
 struct loop_data {
-    explicit loop_data(loop handle);
+    loop_data(loop handle, const loop_options& options);
     ~loop_data();
 
     loop_data(const loop_data&) = delete;
@@ -48,6 +50,21 @@ struct loop_data {
 #endif
 };
 
+// access point to a loop's data. slots are never freed, so finding the slot of a loop handle needs no locking,
+// and the slot mutex guards both the data pointer and all operations on the loop's data.
+struct loop_slot {
+    loop_slot();
+
+    loop_slot(const loop_slot&) = delete;
+    loop_slot(loop_slot&&) = delete;
+    loop_slot& operator=(const loop_slot&) = delete;
+    loop_slot& operator=(loop_slot&&) = delete;
+
+    std::mutex mutex;
+    loop handle;
+    loop_data* data;
+};
+
 struct looper_data {
     looper_data();
 
@@ -56,17 +73,23 @@ struct looper_data {
     looper_data& operator=(const looper_data&) = delete;
     looper_data& operator=(looper_data&&) = delete;
 
-    // todo: we use this mutex everywhere, could be problematic, limit use. perhaps remove lock from loop layer, how?
-    //  could use some lock-less mechanisms
+    // only guards creation and destruction of loops. operations on a loop lock that loop's slot, so
+    // different loops do not contend with each other.
     std::mutex mutex;
     handles::handle_table<loop_data, loops_count> loops;
+    loop_slot slots[loops_count];
 };
 
+using loop_lock = std::unique_lock<std::mutex>;
+
 looper_data& get_global_loop_data();
 
-std::optional<loop_data*> try_get_loop(loop loop);
-loop_data& get_loop(loop loop);
+void attach_loop(loop loop, loop_data* data);
+void detach_loop(loop loop);
+
+std::pair<loop_lock, std::optional<loop_data*>> try_lock_loop(loop loop);
+std::pair<loop_lock, loop_data&> lock_loop(loop loop);
 loop get_loop_handle(handle handle);
-loop_data& get_loop_from_handle(handle handle);
+std::pair<loop_lock, loop_data&> lock_loop_from_handle(handle handle);
 
 }
@@ -6,9 +6,7 @@ namespace looper {
 #define log_module looper_log_module
 
 tcp create_tcp(const loop loop) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop(loop);
+    auto [lock, data] = lock_loop(loop);
 
     auto tcp = os::tcp::create();
     auto [handle, tcp_impl] = data.tcps.allocate_new(data.loop, std::move(tcp));
@@ -19,9 +17,7 @@ tcp create_tcp(const loop loop) {
 }
 
 void destroy_tcp(const tcp tcp) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(tcp);
+    auto [lock, data] = lock_loop_from_handle(tcp);
 
     looper_trace_info(log_module, "destroying tcp: loop=%lu, handle=%lu", data.handle, tcp);
 
@@ -30,9 +26,7 @@ void destroy_tcp(const tcp tcp) {
 }
 
 void bind_tcp(const tcp tcp, const uint16_t port) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(tcp);
+    auto [lock, data] = lock_loop_from_handle(tcp);
 
     looper_trace_info(log_module, "binding tcp: loop=%lu, handle=%lu, port=%d", data.handle, tcp, port);
 
@@ -41,9 +35,7 @@ void bind_tcp(const tcp tcp, const uint16_t port) {
 }
 
 void bind_tcp(const tcp tcp, const std::string_view address, const uint16_t port) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(tcp);
+    auto [lock, data] = lock_loop_from_handle(tcp);
 
     looper_trace_info(log_module, "binding tcp: loop=%lu, handle=%lu, address=%s:%d", data.handle, tcp, address.data(), port);
 
@@ -52,9 +44,7 @@ void bind_tcp(const tcp tcp, const std::string_view address, const uint16_t port
 }
 
 void connect_tcp(const tcp tcp, const std::string_view address, const uint16_t port, connect_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(tcp);
+    auto [lock, data] = lock_loop_from_handle(tcp);
 
     looper_trace_info(log_module, "connecting tcp: loop=%lu, handle=%lu, address=%s, port=%d", data.handle, tcp, address.data(), port);
 
@@ -63,9 +53,7 @@ void connect_tcp(const tcp tcp, const std::string_view address, const uint16_t p
 }
 
 void start_tcp_read(const tcp tcp, read_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(tcp);
+    auto [lock, data] = lock_loop_from_handle(tcp);
 
     looper_trace_info(log_module, "starting tcp read: loop=%lu, handle=%lu", data.handle, tcp);
 
@@ -73,10 +61,17 @@ void start_tcp_read(const tcp tcp, read_callback&& callback) {
     throw_if_error(tcp_impl.start_read(std::move(callback)));
 }
 
-void stop_tcp_read(const tcp tcp) {
-    std::unique_lock lock(get_global_loop_data().mutex);
+void start_tcp_read(const tcp tcp, read_buffer_provider&& provider, read_callback&& callback) {
+    auto [lock, data] = lock_loop_from_handle(tcp);
+
+    looper_trace_info(log_module, "starting tcp read into provided buffers: loop=%lu, handle=%lu", data.handle, tcp);
 
-    auto& data = get_loop_from_handle(tcp);
+    auto& tcp_impl = data.tcps[tcp];
+    throw_if_error(tcp_impl.start_read(std::move(callback), std::move(provider)));
+}
+
+void stop_tcp_read(const tcp tcp) {
+    auto [lock, data] = lock_loop_from_handle(tcp);
 
     looper_trace_info(log_module, "stopping tcp read: loop=%lu, handle=%lu", data.handle, tcp);
 
@@ -84,31 +79,42 @@ void stop_tcp_read(const tcp tcp) {
     throw_if_error(tcp_impl.stop_read());
 }
 
-void write_tcp(const tcp tcp, const std::span<const uint8_t> buffer, write_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(tcp);
+void write_tcp(const tcp tcp, shared_buffer buffer, const size_t size, write_callback&& callback) {
+    auto [lock, data] = lock_loop_from_handle(tcp);
 
-    looper_trace_info(log_module, "writing to tcp: loop=%lu, handle=%lu, data_size=%lu", data.handle, tcp, buffer.size_bytes());
+    looper_trace_info(log_module, "writing to tcp: loop=%lu, handle=%lu, data_size=%lu", data.handle, tcp, size);
 
     auto& tcp_impl = data.tcps[tcp];
 
-    const auto buffer_size = buffer.size_bytes();
     impl::stream_write_request request{};
-    request.buffer = std::unique_ptr<uint8_t[]>(new uint8_t[buffer_size]);
+    request.buffer = std::move(buffer);
     request.pos = 0;
-    request.size = buffer.size_bytes();
+    request.size = size;
     request.write_callback = std::move(callback);
 
-    memcpy(request.buffer.get(), buffer.data(), buffer_size);
-
     throw_if_error(tcp_impl.write(std::move(request)));
 }
 
-tcp_server create_tcp_server(const loop loop) {
-    std::unique_lock lock(get_global_loop_data().mutex);
+void write_tcp(const tcp tcp, const std::span<const uint8_t> buffer, write_callback&& callback) {
+    const auto buffer_size = buffer.size_bytes();
+    auto copy = std::make_shared_for_overwrite<uint8_t[]>(buffer_size);
+    memcpy(copy.get(), buffer.data(), buffer_size);
+
+    write_tcp(tcp, std::move(copy), buffer_size, std::move(callback));
+}
+
+void write_tcp(const tcp tcp, std::unique_ptr<uint8_t[]>&& buffer, const size_t size, write_callback&& callback) {
+    write_tcp(tcp, shared_buffer(std::move(buffer)), size, std::move(callback));
+}
 
-    auto& data = get_loop(loop);
+void write_tcp(const tcp tcp, std::vector<uint8_t>&& buffer, write_callback&& callback) {
+    const auto size = buffer.size();
+    auto holder = std::make_shared<std::vector<uint8_t>>(std::move(buffer));
+    write_tcp(tcp, shared_buffer(holder, holder->data()), size, std::move(callback));
+}
+
+tcp_server create_tcp_server(const loop loop) {
+    auto [lock, data] = lock_loop(loop);
 
     auto tcp = os::tcp::create();
     auto [handle, tcp_impl] = data.tcp_servers.allocate_new(data.loop, std::move(tcp));
@@ -119,9 +125,7 @@ tcp_server create_tcp_server(const loop loop) {
 }
 
 void destroy_tcp_server(const tcp_server tcp) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(tcp);
+    auto [lock, data] = lock_loop_from_handle(tcp);
 
     looper_trace_info(log_module, "destroying tcp server: loop=%lu, handle=%lu", data.handle, tcp);
 
@@ -130,9 +134,7 @@ void destroy_tcp_server(const tcp_server tcp) {
 }
 
 void bind_tcp_server(const tcp_server tcp, const std::string_view address, const uint16_t port) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(tcp);
+    auto [lock, data] = lock_loop_from_handle(tcp);
 
     looper_trace_info(log_module, "binding tcp server: loop=%lu, handle=%lu, address=%s, port=%d", data.handle, tcp, address.data(), port);
 
@@ -141,9 +143,7 @@ void bind_tcp_server(const tcp_server tcp, const std::string_view address, const
 }
 
 void bind_tcp_server(const tcp_server tcp, const uint16_t port) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(tcp);
+    auto [lock, data] = lock_loop_from_handle(tcp);
 
     looper_trace_info(log_module, "binding tcp server: loop=%lu, handle=%lu, port=%d", data.handle, tcp, port);
 
@@ -152,9 +152,7 @@ void bind_tcp_server(const tcp_server tcp, const uint16_t port) {
 }
 
 void listen_tcp(const tcp_server tcp, const size_t backlog, listen_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(tcp);
+    auto [lock, data] = lock_loop_from_handle(tcp);
 
     looper_trace_info(log_module, "start listen on tcp server: loop=%lu, handle=%lu, backlog=%lu", data.handle, tcp, backlog);
 
@@ -163,9 +161,7 @@ void listen_tcp(const tcp_server tcp, const size_t backlog, listen_callback&& ca
 }
 
 tcp accept_tcp(const tcp_server tcp) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(tcp);
+    auto [lock, data] = lock_loop_from_handle(tcp);
 
     looper_trace_info(log_module, "accepting on tcp server: loop=%lu, handle=%lu", data.handle, tcp);
 
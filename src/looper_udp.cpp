@@ -5,10 +5,42 @@ namespace looper {
 
 #define log_module looper_log_module
 
-udp create_udp(const loop loop) {
-    std::unique_lock lock(get_global_loop_data().mutex);
+inet_endpoint make_inet_endpoint(const inet_address_view address) {
+    inet_endpoint endpoint;
+    throw_if_error(os::interface::inet::parse_endpoint(address.ip, address.port, endpoint));
+    return endpoint;
+}
+
+inet_address to_inet_address(const inet_endpoint endpoint) {
+    char ip_buff[os::interface::inet::ip_buffer_size]{};
+    os::interface::inet::format_ip(endpoint, ip_buff, sizeof(ip_buff));
+    return {std::string_view(ip_buff), endpoint.port};
+}
+
+// limits the os places on a single segmented send
+static constexpr size_t max_udp_segment_size = 65535;
+static constexpr size_t max_udp_segments = 64;
+static constexpr size_t max_udp_segmented_size = 65507;
+
+static error verify_segmented_write(const size_t size, const size_t segment_size) {
+    if (segment_size > max_udp_segment_size) {
+        return error_invalid_argument;
+    }
 
-    auto& data = get_loop(loop);
+    if (segment_size == 0 || segment_size >= size) {
+        // sent as a single datagram
+        return error_success;
+    }
+
+    if (size > max_udp_segmented_size || (size + segment_size - 1) / segment_size > max_udp_segments) {
+        return error_invalid_argument;
+    }
+
+    return error_success;
+}
+
+udp create_udp(const loop loop) {
+    auto [lock, data] = lock_loop(loop);
 
     auto obj = os::udp::create();
     auto [handle, udp_impl] = data.udps.allocate_new(data.loop, std::move(obj));
@@ -19,9 +51,7 @@ udp create_udp(const loop loop) {
 }
 
 void destroy_udp(const udp udp) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(udp);
+    auto [lock, data] = lock_loop_from_handle(udp);
 
     looper_trace_info(log_module, "destroying udp: loop=%lu, handle=%lu", data.handle, udp);
 
@@ -30,9 +60,7 @@ void destroy_udp(const udp udp) {
 }
 
 void bind_udp(const udp udp, const uint16_t port) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(udp);
+    auto [lock, data] = lock_loop_from_handle(udp);
 
     looper_trace_info(log_module, "binding udp: loop=%lu, handle=%lu, port=%d", data.handle, udp, port);
 
@@ -41,9 +69,7 @@ void bind_udp(const udp udp, const uint16_t port) {
 }
 
 void start_udp_read(const udp udp, udp_read_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(udp);
+    auto [lock, data] = lock_loop_from_handle(udp);
 
     looper_trace_info(log_module, "starting udp read: loop=%lu, handle=%lu", data.handle, udp);
 
@@ -51,10 +77,53 @@ void start_udp_read(const udp udp, udp_read_callback&& callback) {
     throw_if_error(udp_impl.start_read(std::move(callback)));
 }
 
-void stop_udp_read(const udp udp) {
-    std::unique_lock lock(get_global_loop_data().mutex);
+void start_udp_read(const udp udp, read_buffer_provider&& provider, udp_read_callback&& callback) {
+    auto [lock, data] = lock_loop_from_handle(udp);
+
+    looper_trace_info(log_module, "starting udp read into provided buffers: loop=%lu, handle=%lu", data.handle, udp);
+
+    auto& udp_impl = data.udps[udp];
+    throw_if_error(udp_impl.start_read(std::move(callback), std::move(provider)));
+}
+
+void start_udp_read_endpoint(const udp udp, udp_endpoint_read_callback&& callback) {
+    auto [lock, data] = lock_loop_from_handle(udp);
+
+    looper_trace_info(log_module, "starting udp endpoint read: loop=%lu, handle=%lu", data.handle, udp);
+
+    auto& udp_impl = data.udps[udp];
+    throw_if_error(udp_impl.start_read(std::move(callback)));
+}
+
+void start_udp_read_endpoint(const udp udp, read_buffer_provider&& provider, udp_endpoint_read_callback&& callback) {
+    auto [lock, data] = lock_loop_from_handle(udp);
+
+    looper_trace_info(log_module, "starting udp endpoint read into provided buffers: loop=%lu, handle=%lu", data.handle, udp);
+
+    auto& udp_impl = data.udps[udp];
+    throw_if_error(udp_impl.start_read(std::move(callback), std::move(provider)));
+}
+
+void start_udp_read_batch(const udp udp, udp_batch_read_callback&& callback, const size_t batch_size, const size_t max_datagram_size) {
+    auto [lock, data] = lock_loop_from_handle(udp);
+
+    looper_trace_info(log_module, "starting udp batch read: loop=%lu, handle=%lu, batch_size=%lu", data.handle, udp, batch_size);
+
+    auto& udp_impl = data.udps[udp];
+    throw_if_error(udp_impl.start_read_batch(std::move(callback), batch_size, max_datagram_size));
+}
 
-    auto& data = get_loop_from_handle(udp);
+void start_udp_read_segmented(const udp udp, udp_segmented_read_callback&& callback, const size_t max_read_size) {
+    auto [lock, data] = lock_loop_from_handle(udp);
+
+    looper_trace_info(log_module, "starting udp segmented read: loop=%lu, handle=%lu, max_read_size=%lu", data.handle, udp, max_read_size);
+
+    auto& udp_impl = data.udps[udp];
+    throw_if_error(udp_impl.start_read_segmented(std::move(callback), max_read_size));
+}
+
+void stop_udp_read(const udp udp) {
+    auto [lock, data] = lock_loop_from_handle(udp);
 
     looper_trace_info(log_module, "stopping udp read: loop=%lu, handle=%lu", data.handle, udp);
 
@@ -62,25 +131,139 @@ void stop_udp_read(const udp udp) {
     throw_if_error(udp_impl.stop_read());
 }
 
-void write_udp(const udp udp, inet_address_view destination, const std::span<const uint8_t> buffer, udp_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
+void write_udp(const udp udp, const inet_endpoint destination, shared_buffer buffer, const size_t size, udp_callback&& callback) {
+    auto [lock, data] = lock_loop_from_handle(udp);
 
-    auto& data = get_loop_from_handle(udp);
-
-    looper_trace_info(log_module, "writing to udp: loop=%lu, handle=%lu, data_size=%lu, to=%s:%d", data.handle, udp, buffer.size_bytes(), destination.ip.data(), destination.port);
+    looper_trace_info(log_module, "writing to udp: loop=%lu, handle=%lu, data_size=%lu, to=0x%x:%d", data.handle, udp, size, destination.ip, destination.port);
 
     auto& udp_impl = data.udps[udp];
 
-    const auto buffer_size = buffer.size_bytes();
-    impl::udp_write_request request;
+    impl::udp_write_request request{};
     request.destination = destination;
-    request.buffer = std::unique_ptr<uint8_t[]>(new uint8_t[buffer_size]);
-    request.size = buffer_size;
+    request.buffer = std::move(buffer);
+    request.pos = 0;
+    request.size = size;
     request.write_callback = std::move(callback);
 
-    memcpy(request.buffer.get(), buffer.data(), buffer_size);
+    throw_if_error(udp_impl.write(std::move(request)));
+}
+
+void write_udp(const udp udp, const inet_endpoint destination, const std::span<const uint8_t> buffer, udp_callback&& callback) {
+    const auto buffer_size = buffer.size_bytes();
+    auto copy = std::make_shared_for_overwrite<uint8_t[]>(buffer_size);
+    memcpy(copy.get(), buffer.data(), buffer_size);
+
+    write_udp(udp, destination, std::move(copy), buffer_size, std::move(callback));
+}
+
+void write_udp(const udp udp, const inet_endpoint destination, std::unique_ptr<uint8_t[]>&& buffer, const size_t size, udp_callback&& callback) {
+    write_udp(udp, destination, shared_buffer(std::move(buffer)), size, std::move(callback));
+}
+
+void write_udp(const udp udp, const inet_endpoint destination, std::vector<uint8_t>&& buffer, udp_callback&& callback) {
+    const auto size = buffer.size();
+    auto holder = std::make_shared<std::vector<uint8_t>>(std::move(buffer));
+    write_udp(udp, destination, shared_buffer(holder, holder->data()), size, std::move(callback));
+}
+
+void write_udp(const udp udp, const inet_address_view destination, shared_buffer buffer, const size_t size, udp_callback&& callback) {
+    write_udp(udp, make_inet_endpoint(destination), std::move(buffer), size, std::move(callback));
+}
+
+void write_udp(const udp udp, const inet_address_view destination, const std::span<const uint8_t> buffer, udp_callback&& callback) {
+    write_udp(udp, make_inet_endpoint(destination), buffer, std::move(callback));
+}
+
+void write_udp(const udp udp, const inet_address_view destination, std::unique_ptr<uint8_t[]>&& buffer, const size_t size, udp_callback&& callback) {
+    write_udp(udp, make_inet_endpoint(destination), std::move(buffer), size, std::move(callback));
+}
+
+void write_udp(const udp udp, const inet_address_view destination, std::vector<uint8_t>&& buffer, udp_callback&& callback) {
+    write_udp(udp, make_inet_endpoint(destination), std::move(buffer), std::move(callback));
+}
+
+void write_udp_batch(const udp udp, const std::span<const udp_message> messages, udp_callback&& callback) {
+    // all the data is copied into one allocation, which the requests share
+    size_t total_size = 0;
+    for (const auto& message : messages) {
+        total_size += message.data.size_bytes();
+    }
+    auto storage = std::make_shared_for_overwrite<uint8_t[]>(total_size);
+
+    std::vector<impl::udp_write_request> requests;
+    requests.reserve(messages.size());
+
+    size_t offset = 0;
+    for (const auto& message : messages) {
+        const auto size = message.data.size_bytes();
+        memcpy(storage.get() + offset, message.data.data(), size);
+
+        auto& request = requests.emplace_back();
+        request.destination = message.destination;
+        request.buffer = shared_buffer(storage, storage.get() + offset);
+        request.pos = 0;
+        request.size = size;
+        request.error = error_success;
+        request.write_callback = callback;
+
+        offset += size;
+    }
+
+    auto [lock, data] = lock_loop_from_handle(udp);
+
+    looper_trace_info(log_module, "writing batch to udp: loop=%lu, handle=%lu, count=%lu, data_size=%lu", data.handle, udp, messages.size(), total_size);
+
+    auto& udp_impl = data.udps[udp];
+    throw_if_error(udp_impl.write_many(std::move(requests)));
+}
+
+void write_udp_batch(const udp udp, const std::span<const udp_address_message> messages, udp_callback&& callback) {
+    std::vector<udp_message> resolved;
+    resolved.reserve(messages.size());
+    for (const auto& message : messages) {
+        resolved.push_back({make_inet_endpoint(message.destination), message.data});
+    }
+
+    write_udp_batch(udp, resolved, std::move(callback));
+}
+
+void write_udp_segmented(const udp udp, const inet_endpoint destination, shared_buffer buffer, const size_t size, const size_t segment_size, udp_callback&& callback) {
+    throw_if_error(verify_segmented_write(size, segment_size));
+
+    auto [lock, data] = lock_loop_from_handle(udp);
+
+    looper_trace_info(log_module, "writing segmented to udp: loop=%lu, handle=%lu, data_size=%lu, segment_size=%lu, to=0x%x:%d",
+                      data.handle, udp, size, segment_size, destination.ip, destination.port);
+
+    auto& udp_impl = data.udps[udp];
+
+    impl::udp_write_request request{};
+    request.destination = destination;
+    request.buffer = std::move(buffer);
+    request.pos = 0;
+    request.size = size;
+    request.segment_size = segment_size < size ? segment_size : 0;
+    request.write_callback = std::move(callback);
 
     throw_if_error(udp_impl.write(std::move(request)));
 }
 
+void write_udp_segmented(const udp udp, const inet_endpoint destination, const std::span<const uint8_t> buffer, const size_t segment_size, udp_callback&& callback) {
+    const auto buffer_size = buffer.size_bytes();
+    throw_if_error(verify_segmented_write(buffer_size, segment_size));
+
+    auto copy = std::make_shared_for_overwrite<uint8_t[]>(buffer_size);
+    memcpy(copy.get(), buffer.data(), buffer_size);
+
+    write_udp_segmented(udp, destination, std::move(copy), buffer_size, segment_size, std::move(callback));
+}
+
+void write_udp_segmented(const udp udp, const inet_address_view destination, shared_buffer buffer, const size_t size, const size_t segment_size, udp_callback&& callback) {
+    write_udp_segmented(udp, make_inet_endpoint(destination), std::move(buffer), size, segment_size, std::move(callback));
+}
+
+void write_udp_segmented(const udp udp, const inet_address_view destination, const std::span<const uint8_t> buffer, const size_t segment_size, udp_callback&& callback) {
+    write_udp_segmented(udp, make_inet_endpoint(destination), buffer, segment_size, std::move(callback));
+}
+
 }
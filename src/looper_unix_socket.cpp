@@ -6,9 +6,7 @@ namespace looper {
 #define log_module looper_log_module
 
 unix_socket create_unix_socket(const loop loop) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop(loop);
+    auto [lock, data] = lock_loop(loop);
 
     auto obj = os::unix_socket::create();
     auto [handle, unix_socket_impl] = data.unix_sockets.allocate_new(data.loop, std::move(obj));
@@ -19,9 +17,7 @@ unix_socket create_unix_socket(const loop loop) {
 }
 
 void destroy_unix_socket(const unix_socket unix_socket) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(unix_socket);
+    auto [lock, data] = lock_loop_from_handle(unix_socket);
 
     looper_trace_info(log_module, "destroying unix_socket: loop=%lu, handle=%lu", data.handle, unix_socket);
 
@@ -30,9 +26,7 @@ void destroy_unix_socket(const unix_socket unix_socket) {
 }
 
 void bind_unix_socket(const unix_socket unix_socket, const std::string_view path) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(unix_socket);
+    auto [lock, data] = lock_loop_from_handle(unix_socket);
 
     looper_trace_info(log_module, "binding unix_socket: loop=%lu, handle=%lu, path=%s", data.handle, unix_socket, path.data());
 
@@ -41,9 +35,7 @@ void bind_unix_socket(const unix_socket unix_socket, const std::string_view path
 }
 
 void connect_unix_socket(const unix_socket unix_socket, const std::string_view path, connect_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(unix_socket);
+    auto [lock, data] = lock_loop_from_handle(unix_socket);
 
     looper_trace_info(log_module, "connecting unix_socket: loop=%lu, handle=%lu, path=%s", data.handle, unix_socket, path.data());
 
@@ -52,9 +44,7 @@ void connect_unix_socket(const unix_socket unix_socket, const std::string_view p
 }
 
 void start_unix_socket_read(const unix_socket unix_socket, read_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(unix_socket);
+    auto [lock, data] = lock_loop_from_handle(unix_socket);
 
     looper_trace_info(log_module, "starting unix_socket read: loop=%lu, handle=%lu", data.handle, unix_socket);
 
@@ -62,10 +52,17 @@ void start_unix_socket_read(const unix_socket unix_socket, read_callback&& callb
     throw_if_error(unix_socket_impl.start_read(std::move(callback)));
 }
 
-void stop_unix_socket_read(const unix_socket unix_socket) {
-    std::unique_lock lock(get_global_loop_data().mutex);
+void start_unix_socket_read(const unix_socket unix_socket, read_buffer_provider&& provider, read_callback&& callback) {
+    auto [lock, data] = lock_loop_from_handle(unix_socket);
 
-    auto& data = get_loop_from_handle(unix_socket);
+    looper_trace_info(log_module, "starting unix_socket read into provided buffers: loop=%lu, handle=%lu", data.handle, unix_socket);
+
+    auto& unix_socket_impl = data.unix_sockets[unix_socket];
+    throw_if_error(unix_socket_impl.start_read(std::move(callback), std::move(provider)));
+}
+
+void stop_unix_socket_read(const unix_socket unix_socket) {
+    auto [lock, data] = lock_loop_from_handle(unix_socket);
 
     looper_trace_info(log_module, "stopping unix_socket read: loop=%lu, handle=%lu", data.handle, unix_socket);
 
@@ -73,31 +70,42 @@ void stop_unix_socket_read(const unix_socket unix_socket) {
     throw_if_error(unix_socket_impl.stop_read());
 }
 
-void write_unix_socket(const unix_socket unix_socket, const std::span<const uint8_t> buffer, unix_socket_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
+void write_unix_socket(const unix_socket unix_socket, shared_buffer buffer, const size_t size, unix_socket_callback&& callback) {
+    auto [lock, data] = lock_loop_from_handle(unix_socket);
 
-    auto& data = get_loop_from_handle(unix_socket);
-
-    looper_trace_info(log_module, "writing to unix_socket: loop=%lu, handle=%lu, data_size=%lu", data.handle, unix_socket, buffer.size_bytes());
+    looper_trace_info(log_module, "writing to unix_socket: loop=%lu, handle=%lu, data_size=%lu", data.handle, unix_socket, size);
 
     auto& unix_socket_impl = data.unix_sockets[unix_socket];
 
-    const auto buffer_size = buffer.size_bytes();
     impl::stream_write_request request{};
-    request.buffer = std::unique_ptr<uint8_t[]>(new uint8_t[buffer_size]);
+    request.buffer = std::move(buffer);
     request.pos = 0;
-    request.size = buffer.size_bytes();
+    request.size = size;
     request.write_callback = std::move(callback);
 
-    memcpy(request.buffer.get(), buffer.data(), buffer_size);
-
     throw_if_error(unix_socket_impl.write(std::move(request)));
 }
 
-unix_socket_server create_unix_socket_server(const loop loop) {
-    std::unique_lock lock(get_global_loop_data().mutex);
+void write_unix_socket(const unix_socket unix_socket, const std::span<const uint8_t> buffer, unix_socket_callback&& callback) {
+    const auto buffer_size = buffer.size_bytes();
+    auto copy = std::make_shared_for_overwrite<uint8_t[]>(buffer_size);
+    memcpy(copy.get(), buffer.data(), buffer_size);
+
+    write_unix_socket(unix_socket, std::move(copy), buffer_size, std::move(callback));
+}
+
+void write_unix_socket(const unix_socket unix_socket, std::unique_ptr<uint8_t[]>&& buffer, const size_t size, unix_socket_callback&& callback) {
+    write_unix_socket(unix_socket, shared_buffer(std::move(buffer)), size, std::move(callback));
+}
 
-    auto& data = get_loop(loop);
+void write_unix_socket(const unix_socket unix_socket, std::vector<uint8_t>&& buffer, unix_socket_callback&& callback) {
+    const auto size = buffer.size();
+    auto holder = std::make_shared<std::vector<uint8_t>>(std::move(buffer));
+    write_unix_socket(unix_socket, shared_buffer(holder, holder->data()), size, std::move(callback));
+}
+
+unix_socket_server create_unix_socket_server(const loop loop) {
+    auto [lock, data] = lock_loop(loop);
 
     auto obj = os::unix_socket::create();
     auto [handle, unix_socket_impl] = data.unix_socket_servers.allocate_new(data.loop, std::move(obj));
@@ -108,9 +116,7 @@ unix_socket_server create_unix_socket_server(const loop loop) {
 }
 
 void destroy_unix_socket_server(const unix_socket_server unix_socket) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(unix_socket);
+    auto [lock, data] = lock_loop_from_handle(unix_socket);
 
     looper_trace_info(log_module, "destroying unix_socket server: loop=%lu, handle=%lu", data.handle, unix_socket);
 
@@ -119,9 +125,7 @@ void destroy_unix_socket_server(const unix_socket_server unix_socket) {
 }
 
 void bind_unix_socket_server(const unix_socket_server unix_socket, const std::string_view path) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(unix_socket);
+    auto [lock, data] = lock_loop_from_handle(unix_socket);
 
     looper_trace_info(log_module, "binding unix_socket server: loop=%lu, handle=%lu, path=%s", data.handle, unix_socket, path.data());
 
@@ -130,9 +134,7 @@ void bind_unix_socket_server(const unix_socket_server unix_socket, const std::st
 }
 
 void listen_unix_socket(const unix_socket_server unix_socket, const size_t backlog, listen_callback&& callback) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(unix_socket);
+    auto [lock, data] = lock_loop_from_handle(unix_socket);
 
     looper_trace_info(log_module, "start listen on unix_socket server: loop=%lu, handle=%lu, backlog=%lu", data.handle, unix_socket, backlog);
 
@@ -141,9 +143,7 @@ void listen_unix_socket(const unix_socket_server unix_socket, const size_t backl
 }
 
 unix_socket accept_unix_socket(const unix_socket_server unix_socket) {
-    std::unique_lock lock(get_global_loop_data().mutex);
-
-    auto& data = get_loop_from_handle(unix_socket);
+    auto [lock, data] = lock_loop_from_handle(unix_socket);
 
     looper_trace_info(log_module, "accepting on unix_socket server: loop=%lu, handle=%lu", data.handle, unix_socket);
 
@@ -33,6 +33,9 @@ static uint32_t events_to_native(const event_type events) {
     if ((events & event_type::hung) != 0) {
         r_events |= EPOLLHUP;
     }
+    if ((events & event_type::edge) != 0) {
+        r_events |= EPOLLET;
+    }
 
     return r_events;
 }
@@ -95,10 +98,10 @@ void close(const poller* poller) noexcept {
     delete poller;
 }
 
-looper::error add(const poller* poller, const os::descriptor descriptor, const event_type events) noexcept {
+looper::error add(const poller* poller, const os::descriptor descriptor, const event_type events, const uint64_t user_data) noexcept {
     epoll_event event{};
     event.events = events_to_native(events);
-    event.data.fd = descriptor;
+    event.data.u64 = user_data;
 
     if (::epoll_ctl(poller->fd, EPOLL_CTL_ADD, descriptor, &event)) {
         return get_call_error();
@@ -107,10 +110,10 @@ looper::error add(const poller* poller, const os::descriptor descriptor, const e
     return error_success;
 }
 
-looper::error set(const poller* poller, const os::descriptor descriptor, const event_type events) noexcept {
+looper::error set(const poller* poller, const os::descriptor descriptor, const event_type events, const uint64_t user_data) noexcept {
     epoll_event event{};
     event.events = events_to_native(events);
-    event.data.fd = descriptor;
+    event.data.u64 = user_data;
 
     if (::epoll_ctl(poller->fd, EPOLL_CTL_MOD, descriptor, &event)) {
         return get_call_error();
@@ -122,7 +125,6 @@ looper::error set(const poller* poller, const os::descriptor descriptor, const e
 looper::error remove(const poller* poller, const os::descriptor descriptor) noexcept {
     epoll_event event{};
     event.events = 0;
-    event.data.fd = descriptor;
 
     if (::epoll_ctl(poller->fd, EPOLL_CTL_DEL, descriptor, &event)) {
         return get_call_error();
@@ -161,7 +163,7 @@ looper::error poll(poller* poller,
         auto& event = poller->events[i];
         auto& event_out = events[i];
 
-        event_out.descriptor = event.data.fd;
+        event_out.user_data = event.data.u64;
         event_out.events = native_to_events(event.events);
     }
 
@@ -26,5 +26,6 @@ static looper::error get_call_error() {
 
 looper::error io_read(os::descriptor descriptor, uint8_t* buffer, size_t buffer_size, size_t& read_out);
 looper::error io_write(os::descriptor descriptor, const uint8_t* buffer, size_t size, size_t& written_out);
+looper::error io_writev(os::descriptor descriptor, const io_buffer* buffers, size_t count, size_t& written_out);
 
 }
\ No newline at end of file
@@ -1,3 +1,7 @@
+#include <sys/uio.h>
+#include <climits>
+#include <algorithm>
+
 #include "linux.h"
 
 namespace looper::os::interface {
@@ -17,14 +21,7 @@ looper::error io_read(
         return error_eof;
     }
     if (result < 0) {
-        const auto error_code = get_call_error();
-        if (error_code == error_again) {
-            // while in non-blocking mode, socket operations may return eagain if
-            // the operation will end up blocking, as such just return.
-            read_out = 0;
-            return error_success;
-        }
-
+        // while in non-blocking mode, this is error_again if the read would block
         return get_call_error();
     }
 
@@ -46,4 +43,25 @@ looper::error io_write(
     return error_success;
 }
 
+looper::error io_writev(
+    const os::descriptor descriptor,
+    const io_buffer* buffers,
+    const size_t count,
+    size_t& written_out) {
+    iovec vecs[IOV_MAX];
+    const auto vec_count = std::min<size_t>(count, IOV_MAX);
+    for (size_t i = 0; i < vec_count; i++) {
+        vecs[i].iov_base = const_cast<uint8_t*>(buffers[i].data());
+        vecs[i].iov_len = buffers[i].size();
+    }
+
+    const auto result = ::writev(descriptor, vecs, static_cast<int>(vec_count));
+    if (result < 0) {
+        return get_call_error();
+    }
+
+    written_out = result;
+    return error_success;
+}
+
 }
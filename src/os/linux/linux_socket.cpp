@@ -3,10 +3,12 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <new>
+#include <algorithm>
 
 #ifdef LOOPER_UNIX_SOCKETS
 #include <sys/un.h>
@@ -15,6 +17,14 @@
 #include "os/linux/linux.h"
 #include "os/os_interface.h"
 
+// not defined by older libc headers, even where the kernel supports them
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
 namespace looper::os::interface {
 
 namespace detail {
@@ -158,14 +168,24 @@ looper::error write_socket_stream(const os::descriptor descriptor, const uint8_t
     return error_success;
 }
 
+sockaddr_in endpoint_to_sockaddr(const inet_endpoint& endpoint) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = ::htons(endpoint.port);
+    addr.sin_addr.s_addr = endpoint.ip;
+    return addr;
+}
+
+inet_endpoint sockaddr_to_endpoint(const sockaddr_in& addr) {
+    return inet_endpoint{addr.sin_addr.s_addr, ntohs(addr.sin_port)};
+}
+
 looper::error readfrom_socket_dgram(
     const os::descriptor descriptor,
     uint8_t* buffer,
     const size_t buffer_size,
     size_t& read_out,
-    char* sender_ip_buff,
-    const size_t sender_ip_buff_size,
-    uint16_t& sender_port_out) {
+    inet_endpoint& sender_out) {
     if (buffer_size == 0) {
         read_out = 0;
         return error_success;
@@ -180,48 +200,118 @@ looper::error readfrom_socket_dgram(
         0,
         reinterpret_cast<sockaddr*>(&addr),
         &addr_len);
-    if (result == 0) {
-        return error_eof;
-    }
     if (result < 0) {
-        const auto error_code = get_call_error();
-        if (error_code == error_again) {
-            // while in non-blocking mode, socket operations may return eagain if
-            // the operation will end up blocking, as such just return.
-            read_out = 0;
-            return error_success;
+        // while in non-blocking mode, this is error_again if the read would block.
+        // a result of 0 is not an end of stream, but an empty datagram.
+        return get_call_error();
+    }
+
+    read_out = result;
+    sender_out = sockaddr_to_endpoint(addr);
+
+    return error_success;
+}
+
+looper::error readfrom_socket_dgram_segmented(
+    const os::descriptor descriptor,
+    uint8_t* buffer,
+    const size_t buffer_size,
+    size_t& read_out,
+    size_t& segment_size_out,
+    inet_endpoint& sender_out) {
+    sockaddr_in addr{};
+    iovec vec{buffer, buffer_size};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+
+    msghdr message{};
+    ssize_t result;
+    do {
+        message = {};
+        message.msg_name = &addr;
+        message.msg_namelen = sizeof(addr);
+        message.msg_iov = &vec;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        result = ::recvmsg(descriptor, &message, 0);
+        if (result < 0) {
+            // while in non-blocking mode, this is error_again if the read would block
+            return get_call_error();
         }
 
-        return get_call_error();
+        // the rest of a truncated read is lost, and with it the sizes of the datagrams in it. so it is dropped
+        // rather than given as if it was whole.
+    } while ((message.msg_flags & MSG_TRUNC) != 0);
+
+    // without the segment size, the os did not coalesce and this is a single datagram
+    size_t segment_size = result;
+    for (auto* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_UDP && header->cmsg_type == UDP_GRO) {
+            int value;
+            memcpy(&value, CMSG_DATA(header), sizeof(value));
+            segment_size = value;
+        }
     }
 
     read_out = result;
-    ::inet_ntop(AF_INET, &addr.sin_addr, sender_ip_buff, sender_ip_buff_size);
-    sender_port_out = ntohs(addr.sin_port);
+    segment_size_out = segment_size;
+    sender_out = sockaddr_to_endpoint(addr);
 
     return error_success;
 }
 
+looper::error readfrom_socket_dgram_many(
+    const os::descriptor descriptor,
+    udp::datagram* datagrams,
+    size_t count,
+    size_t& read_count_out) {
+    count = std::min(count, udp::max_datagrams_in_read);
+
+    mmsghdr messages[udp::max_datagrams_in_read];
+    iovec vecs[udp::max_datagrams_in_read];
+    sockaddr_in addrs[udp::max_datagrams_in_read];
+    for (size_t i = 0; i < count; i++) {
+        vecs[i].iov_base = datagrams[i].buffer;
+        vecs[i].iov_len = datagrams[i].buffer_size;
+
+        messages[i] = {};
+        messages[i].msg_hdr.msg_name = &addrs[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        messages[i].msg_hdr.msg_iov = &vecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    const auto result = ::recvmmsg(descriptor, messages, count, 0, nullptr);
+    if (result < 0) {
+        // while in non-blocking mode, this is error_again if the read would block
+        return get_call_error();
+    }
+
+    for (int i = 0; i < result; i++) {
+        auto& datagram = datagrams[i];
+        datagram.size = std::min<size_t>(messages[i].msg_len, datagram.buffer_size);
+        datagram.sender = sockaddr_to_endpoint(addrs[i]);
+    }
+
+    read_count_out = result;
+    return error_success;
+}
+
 looper::error writeto_socket_dgram(
     const os::descriptor descriptor,
-    const std::string_view dest_ip,
-    const uint16_t dest_port,
+    const inet_endpoint& destination,
     const uint8_t* buffer,
     const size_t size,
     size_t& written_out) {
-    const std::string ip_c(dest_ip);
-
-    sockaddr_in addr{};
-    addr.sin_family = AF_INET;
-    addr.sin_port = ::htons(dest_port);
-    ::inet_pton(AF_INET, ip_c.c_str(), &addr.sin_addr);
+    const auto addr = endpoint_to_sockaddr(destination);
 
     const auto result = ::sendto(
         descriptor,
         buffer,
         size,
         0,
-        reinterpret_cast<sockaddr*>(&addr),
+        reinterpret_cast<const sockaddr*>(&addr),
         sizeof(addr));
     if (result < 0) {
         return get_call_error();
@@ -231,6 +321,53 @@ looper::error writeto_socket_dgram(
     return error_success;
 }
 
+looper::error writeto_socket_dgram_many(
+    const os::descriptor descriptor,
+    const udp::outgoing_datagram* datagrams,
+    size_t count,
+    size_t& sent_count_out) {
+    count = std::min(count, udp::max_datagrams_in_write);
+
+    mmsghdr messages[udp::max_datagrams_in_write];
+    iovec vecs[udp::max_datagrams_in_write];
+    sockaddr_in addrs[udp::max_datagrams_in_write];
+    alignas(cmsghdr) char controls[udp::max_datagrams_in_write][CMSG_SPACE(sizeof(uint16_t))];
+    for (size_t i = 0; i < count; i++) {
+        const auto& datagram = datagrams[i];
+        addrs[i] = endpoint_to_sockaddr(datagram.destination);
+
+        vecs[i].iov_base = const_cast<uint8_t*>(datagram.buffer);
+        vecs[i].iov_len = datagram.size;
+
+        messages[i] = {};
+        messages[i].msg_hdr.msg_name = &addrs[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        messages[i].msg_hdr.msg_iov = &vecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+
+        if (datagram.segment_size != 0) {
+            messages[i].msg_hdr.msg_control = controls[i];
+            messages[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+
+            auto* header = CMSG_FIRSTHDR(&messages[i].msg_hdr);
+            header->cmsg_level = SOL_UDP;
+            header->cmsg_type = UDP_SEGMENT;
+            header->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+
+            const auto segment_size = static_cast<uint16_t>(datagram.segment_size);
+            memcpy(CMSG_DATA(header), &segment_size, sizeof(segment_size));
+        }
+    }
+
+    const auto result = ::sendmmsg(descriptor, messages, count, 0);
+    if (result < 0) {
+        return get_call_error();
+    }
+
+    sent_count_out = result;
+    return error_success;
+}
+
 looper::error listen_socket(const os::descriptor descriptor, const size_t backlog_size) {
     if (::listen(descriptor, static_cast<int>(backlog_size))) {
         return get_call_error();
@@ -363,6 +500,32 @@ looper::error connect_socket_unix(const os::descriptor descriptor, const std::st
 
 }
 
+namespace inet {
+
+looper::error parse_endpoint(const std::string_view ip, const uint16_t port, inet_endpoint& endpoint_out) noexcept {
+    char ip_c[ip_buffer_size]{};
+    if (ip.size() >= sizeof(ip_c)) {
+        return error_invalid_address;
+    }
+    memcpy(ip_c, ip.data(), ip.size());
+
+    in_addr addr{};
+    if (::inet_pton(AF_INET, ip_c, &addr) != 1) {
+        return error_invalid_address;
+    }
+
+    endpoint_out = inet_endpoint{addr.s_addr, port};
+    return error_success;
+}
+
+void format_ip(const inet_endpoint& endpoint, char* ip_buff, const size_t ip_buff_size) noexcept {
+    in_addr addr{};
+    addr.s_addr = endpoint.ip;
+    ::inet_ntop(AF_INET, &addr, ip_buff, ip_buff_size);
+}
+
+}
+
 namespace tcp {
 
 struct tcp : public detail::base_socket {
@@ -465,6 +628,17 @@ looper::error write(const tcp* tcp, const uint8_t* buffer, const size_t size, si
     return detail::write_socket_stream(tcp->fd, buffer, size, written_out);
 }
 
+looper::error writev(const tcp* tcp, const io_buffer* buffers, const size_t count, size_t& written_out) noexcept {
+    if (tcp->closed) {
+        return error_fd_closed;
+    }
+    if (tcp->disabled) {
+        return error_operation_not_supported;
+    }
+
+    return io_writev(tcp->fd, buffers, count, written_out);
+}
+
 looper::error listen(const tcp* tcp, const size_t backlog_size) noexcept {
     if (tcp->closed) {
         return error_fd_closed;
@@ -547,20 +721,53 @@ looper::error read(
     uint8_t* buffer,
     const size_t buffer_size,
     size_t& read_out,
-    char* sender_ip_buff,
-    const size_t sender_ip_buff_size,
-    uint16_t& sender_port_out) noexcept {
+    inet_endpoint& sender_out) noexcept {
+    if (udp->closed) {
+        return error_fd_closed;
+    }
+
+    return detail::readfrom_socket_dgram(udp->fd, buffer, buffer_size, read_out, sender_out);
+}
+
+looper::error set_receive_coalescing(const udp* udp, const bool enabled) noexcept {
     if (udp->closed) {
         return error_fd_closed;
     }
 
-    return detail::readfrom_socket_dgram(udp->fd, buffer, buffer_size, read_out, sender_ip_buff, sender_ip_buff_size, sender_port_out);
+    const int value = enabled ? 1 : 0;
+    const auto status = detail::setoption(udp->fd, SOL_UDP, UDP_GRO, &value, sizeof(value));
+    if (status == os_error_to_looper(ENOPROTOOPT)) {
+        return error_operation_not_supported;
+    }
+
+    return status;
+}
+
+looper::error read_segmented(
+    const udp* udp,
+    uint8_t* buffer,
+    const size_t buffer_size,
+    size_t& read_out,
+    size_t& segment_size_out,
+    inet_endpoint& sender_out) noexcept {
+    if (udp->closed) {
+        return error_fd_closed;
+    }
+
+    return detail::readfrom_socket_dgram_segmented(udp->fd, buffer, buffer_size, read_out, segment_size_out, sender_out);
+}
+
+looper::error read_many(const udp* udp, datagram* datagrams, const size_t count, size_t& read_count_out) noexcept {
+    if (udp->closed) {
+        return error_fd_closed;
+    }
+
+    return detail::readfrom_socket_dgram_many(udp->fd, datagrams, count, read_count_out);
 }
 
 looper::error write(
     const udp* udp,
-    const std::string_view dest_ip,
-    const uint16_t dest_port,
+    const inet_endpoint& destination,
     const uint8_t* buffer,
     const size_t size,
     size_t& written_out) noexcept {
@@ -568,7 +775,15 @@ looper::error write(
         return error_fd_closed;
     }
 
-    return detail::writeto_socket_dgram(udp->fd, dest_ip, dest_port, buffer, size, written_out);
+    return detail::writeto_socket_dgram(udp->fd, destination, buffer, size, written_out);
+}
+
+looper::error write_many(const udp* udp, const outgoing_datagram* datagrams, const size_t count, size_t& sent_count_out) noexcept {
+    if (udp->closed) {
+        return error_fd_closed;
+    }
+
+    return detail::writeto_socket_dgram_many(udp->fd, datagrams, count, sent_count_out);
 }
 
 }
@@ -662,6 +877,17 @@ looper::error write(const unix_socket* skt, const uint8_t* buffer, const size_t
     return detail::write_socket_stream(skt->fd, buffer, size, written_out);
 }
 
+looper::error writev(const unix_socket* skt, const io_buffer* buffers, const size_t count, size_t& written_out) noexcept {
+    if (skt->closed) {
+        return error_fd_closed;
+    }
+    if (skt->disabled) {
+        return error_operation_not_supported;
+    }
+
+    return io_writev(skt->fd, buffers, count, written_out);
+}
+
 looper::error listen(const unix_socket* skt, const size_t backlog_size) noexcept {
     if (skt->closed) {
         return error_fd_closed;
@@ -0,0 +1,97 @@
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <new>
+
+#include "os/linux/linux.h"
+#include "os/os_interface.h"
+
+
+namespace looper::os::interface::timer {
+
+static looper::error create_timerfd(os::descriptor& descriptor_out) {
+    const auto fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    if (fd < 0) {
+        return get_call_error();
+    }
+
+    descriptor_out = fd;
+    return error_success;
+}
+
+static looper::error set_timerfd(const os::descriptor descriptor, const std::chrono::nanoseconds deadline) {
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(deadline);
+
+    itimerspec spec{};
+    spec.it_value.tv_sec = seconds.count();
+    spec.it_value.tv_nsec = (deadline - seconds).count();
+
+    if (::timerfd_settime(descriptor, TFD_TIMER_ABSTIME, &spec, nullptr)) {
+        return get_call_error();
+    }
+
+    return error_success;
+}
+
+struct timer {
+    os::descriptor fd;
+};
+
+looper::error create(timer** timer_out) noexcept {
+    os::descriptor descriptor;
+    const auto status = create_timerfd(descriptor);
+    if (status != error_success) {
+        return status;
+    }
+
+    auto* _timer = new (std::nothrow) timer;
+    if (_timer == nullptr) {
+        ::close(descriptor);
+        return error_allocation;
+    }
+
+    _timer->fd = descriptor;
+
+    *timer_out = _timer;
+    return error_success;
+}
+
+void close(const timer* timer) noexcept {
+    ::close(timer->fd);
+
+    delete timer;
+}
+
+descriptor get_descriptor(const timer* timer) noexcept {
+    return timer->fd;
+}
+
+looper::error arm(const timer* timer, const std::chrono::nanoseconds deadline) noexcept {
+    // a zeroed it_value disarms the timer, so a deadline at the very start of the clock is pushed by 1ns
+    if (deadline.count() < 1) {
+        return set_timerfd(timer->fd, std::chrono::nanoseconds(1));
+    }
+
+    return set_timerfd(timer->fd, deadline);
+}
+
+looper::error disarm(const timer* timer) noexcept {
+    return set_timerfd(timer->fd, std::chrono::nanoseconds(0));
+}
+
+looper::error clear(const timer* timer) noexcept {
+    uint64_t expirations;
+    if (::read(timer->fd, &expirations, sizeof(expirations)) < 0) {
+        const auto error_code = get_call_error();
+        if (error_code == error_again) {
+            // timer was re-armed or disarmed after expiring, nothing to clear
+            return error_success;
+        }
+
+        return error_code;
+    }
+
+    return error_success;
+}
+
+}
@@ -37,6 +37,24 @@ struct event_deleter {
     }
 };
 
+struct timer_creator {
+    interface::timer::timer* operator()() const {
+        interface::timer::timer* timer;
+        const auto status = interface::timer::create(&timer);
+        if (status != error_success) {
+            throw os_exception(status);
+        }
+
+        return timer;
+    }
+};
+
+struct timer_deleter {
+    void operator()(const interface::timer::timer* timer) const noexcept {
+        interface::timer::close(timer);
+    }
+};
+
 struct tcp_creator {
     interface::tcp::tcp* operator()() const {
         interface::tcp::tcp* tcp;
@@ -150,6 +168,7 @@ private:
 };
 
 using event = os_object<interface::event::event, detail::event_creator, detail::event_deleter>;
+using timer = os_object<interface::timer::timer, detail::timer_creator, detail::timer_deleter>;
 using tcp = os_object<interface::tcp::tcp, detail::tcp_creator, detail::tcp_deleter>;
 using udp = os_object<interface::udp::udp, detail::udp_creator, detail::udp_deleter>;
 using poller = os_object<interface::poll::poller, detail::poller_creator, detail::poller_deleter>;
@@ -163,7 +182,7 @@ using unix_socket = os_object<interface::unix_sock::unix_socket, detail::unix_so
 namespace detail {
 
 template<typename t_>
-concept os_object_type = std::is_same_v<t_, event> || std::is_same_v<t_, tcp> || std::is_same_v<t_, udp> || std::is_same_v<t_, poller> ||
+concept os_object_type = std::is_same_v<t_, event> || std::is_same_v<t_, timer> || std::is_same_v<t_, tcp> || std::is_same_v<t_, udp> || std::is_same_v<t_, poller> ||
 #ifdef LOOPER_UNIX_SOCKETS
     std::is_same_v<t_, unix_socket>
 #endif
@@ -190,6 +209,13 @@ struct os_descriptor<event> {
     }
 };
 
+template<>
+struct os_descriptor<timer> {
+    static os::descriptor get(const timer& obj) noexcept {
+        return interface::timer::get_descriptor(obj);
+    }
+};
+
 template<>
 struct os_descriptor<tcp> {
     static os::descriptor get(const tcp& obj) noexcept {
@@ -237,6 +263,9 @@ struct os_stream<tcp> {
     static looper::error write(const tcp& obj, const std::span<const uint8_t> buffer, size_t& written_out) noexcept {
         return interface::tcp::write(obj, buffer.data(), buffer.size(), written_out);
     }
+    static looper::error writev(const tcp& obj, const std::span<const io_buffer> buffers, size_t& written_out) noexcept {
+        return interface::tcp::writev(obj, buffers.data(), buffers.size(), written_out);
+    }
 };
 
 template<>
@@ -302,6 +331,9 @@ struct os_stream<unix_socket> {
     static looper::error write(const unix_socket& obj, const std::span<const uint8_t> buffer, size_t& written_out) noexcept {
         return interface::unix_sock::write(obj, buffer.data(), buffer.size(), written_out);
     }
+    static looper::error writev(const unix_socket& obj, const std::span<const io_buffer> buffers, size_t& written_out) noexcept {
+        return interface::unix_sock::writev(obj, buffers.data(), buffers.size(), written_out);
+    }
 };
 
 #endif
@@ -314,6 +346,7 @@ template<typename t_>
 concept os_stream_type = requires(t_ t) {
     { detail::os_stream<t_>::read };
     { detail::os_stream<t_>::write };
+    { detail::os_stream<t_>::writev };
 };
 
 
@@ -332,16 +365,28 @@ template<os_object_type t_>
     return interface::event::clear(obj);
 }
 
-[[nodiscard]] inline looper::error poller_add(const poller& obj, const os::descriptor descriptor, const event_type events) noexcept {
-    return interface::poll::add(obj, descriptor, events);
+[[nodiscard]] inline looper::error timer_arm(const timer& obj, const std::chrono::nanoseconds deadline) noexcept {
+    return interface::timer::arm(obj, deadline);
+}
+
+[[nodiscard]] inline looper::error timer_disarm(const timer& obj) noexcept {
+    return interface::timer::disarm(obj);
+}
+
+[[nodiscard]] inline looper::error timer_clear(const timer& obj) noexcept {
+    return interface::timer::clear(obj);
+}
+
+[[nodiscard]] inline looper::error poller_add(const poller& obj, const os::descriptor descriptor, const event_type events, const uint64_t user_data) noexcept {
+    return interface::poll::add(obj, descriptor, events, user_data);
 }
 
 [[nodiscard]] inline looper::error poller_remove(const poller& obj, const os::descriptor descriptor) noexcept {
     return interface::poll::remove(obj, descriptor);
 }
 
-[[nodiscard]] inline looper::error poller_set(const poller& obj, const os::descriptor descriptor, const event_type events) noexcept {
-    return interface::poll::set(obj, descriptor, events);
+[[nodiscard]] inline looper::error poller_set(const poller& obj, const os::descriptor descriptor, const event_type events, const uint64_t user_data) noexcept {
+    return interface::poll::set(obj, descriptor, events, user_data);
 }
 
 [[nodiscard]] inline looper::error poller_poll(
@@ -393,6 +438,11 @@ template<os_stream_type t_>
     return detail::os_stream<t_>::write(t, buffer, written_out);
 }
 
+template<os_stream_type t_>
+[[nodiscard]] looper::error stream_writev(const t_& t, const std::span<const io_buffer> buffers, size_t& written_out) noexcept {
+    return detail::os_stream<t_>::writev(t, buffers, written_out);
+}
+
 #ifdef LOOPER_UNIX_SOCKETS
 
 template<os_object_type t_>
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <span>
 
 #include <looper_types.h>
 #include "types_internal.h"
@@ -9,6 +10,9 @@ namespace looper::os {
 
 using descriptor = int;
 
+// buffers passed to a single gathering write
+using io_buffer = std::span<const uint8_t>;
+
 namespace interface {
 
 namespace event {
@@ -25,6 +29,22 @@ void close(const event* event) noexcept;
 
 }
 
+namespace timer {
+
+struct timer;
+
+[[nodiscard]] looper::error create(timer** timer_out) noexcept;
+void close(const timer* timer) noexcept;
+
+[[nodiscard]] descriptor get_descriptor(const timer* timer) noexcept;
+
+// deadline is an absolute time point of the monotonic clock (steady_clock)
+[[nodiscard]] looper::error arm(const timer* timer, std::chrono::nanoseconds deadline) noexcept;
+[[nodiscard]] looper::error disarm(const timer* timer) noexcept;
+[[nodiscard]] looper::error clear(const timer* timer) noexcept;
+
+}
+
 namespace tcp {
 
 struct tcp;
@@ -44,6 +64,8 @@ void close(tcp* tcp) noexcept;
 
 [[nodiscard]] looper::error read(const tcp* tcp, uint8_t* buffer, size_t buffer_size, size_t& read_out) noexcept;
 [[nodiscard]] looper::error write(const tcp* tcp, const uint8_t* buffer, size_t size, size_t& written_out) noexcept;
+// writes the buffers in order with a single call. may write only some of them, or part of one.
+[[nodiscard]] looper::error writev(const tcp* tcp, const io_buffer* buffers, size_t count, size_t& written_out) noexcept;
 
 [[nodiscard]] looper::error listen(const tcp* tcp, size_t backlog_size) noexcept;
 [[nodiscard]] looper::error accept(const tcp* this_tcp, tcp** tcp_out) noexcept;
@@ -68,6 +90,7 @@ void close(unix_socket* skt) noexcept;
 
 [[nodiscard]] looper::error read(const unix_socket* skt, uint8_t* buffer, size_t buffer_size, size_t& read_out) noexcept;
 [[nodiscard]] looper::error write(const unix_socket* skt, const uint8_t* buffer, size_t size, size_t& written_out) noexcept;
+[[nodiscard]] looper::error writev(const unix_socket* skt, const io_buffer* buffers, size_t count, size_t& written_out) noexcept;
 
 [[nodiscard]] looper::error listen(const unix_socket* skt, size_t backlog_size) noexcept;
 [[nodiscard]] looper::error accept(const unix_socket* this_skt, unix_socket** skt_out) noexcept;
@@ -76,10 +99,47 @@ void close(unix_socket* skt) noexcept;
 
 #endif
 
+namespace inet {
+
+// large enough for any IPv4 address and its terminator
+static constexpr size_t ip_buffer_size = 16;
+
+[[nodiscard]] looper::error parse_endpoint(std::string_view ip, uint16_t port, inet_endpoint& endpoint_out) noexcept;
+void format_ip(const inet_endpoint& endpoint, char* ip_buff, size_t ip_buff_size) noexcept;
+
+}
+
 namespace udp {
 
 struct udp;
 
+// slot for one datagram received in a batch
+struct datagram {
+    // set by the caller, to receive the datagram into. larger datagrams are truncated.
+    uint8_t* buffer;
+    size_t buffer_size;
+
+    // set once received
+    size_t size;
+    inet_endpoint sender;
+};
+
+// one datagram sent in a batch
+struct outgoing_datagram {
+    inet_endpoint destination;
+    const uint8_t* buffer;
+    size_t size;
+    // if not 0, the buffer is split by the os into datagrams of this size, the last of which may be shorter
+    size_t segment_size;
+};
+
+// the most datagrams received by a single call to read_many
+static constexpr size_t max_datagrams_in_read = 128;
+// the most datagrams sent by a single call to write_many
+static constexpr size_t max_datagrams_in_write = 128;
+// the most data which the os may coalesce into a single segmented read
+static constexpr size_t max_segmented_read_size = 65536;
+
 [[nodiscard]] looper::error create(udp** udp_out) noexcept;
 void close(udp* udp) noexcept;
 
@@ -90,8 +150,19 @@ void close(udp* udp) noexcept;
 [[nodiscard]] looper::error bind(const udp* udp, uint16_t port) noexcept;
 [[nodiscard]] looper::error bind(const udp* udp, std::string_view ip, uint16_t port) noexcept;
 
-[[nodiscard]] looper::error read(const udp* udp, uint8_t* buffer, size_t buffer_size, size_t& read_out, char* sender_ip_buff, size_t sender_ip_buff_size, uint16_t& sender_port_out) noexcept;
-[[nodiscard]] looper::error write(const udp* udp, std::string_view dest_ip, uint16_t dest_port, const uint8_t* buffer, size_t size, size_t& written_out) noexcept;
+[[nodiscard]] looper::error read(const udp* udp, uint8_t* buffer, size_t buffer_size, size_t& read_out, inet_endpoint& sender_out) noexcept;
+// with coalescing enabled, the os may join datagrams of the same flow into a single read, see read_segmented.
+// returns error_operation_not_supported if the os does not support it.
+[[nodiscard]] looper::error set_receive_coalescing(const udp* udp, bool enabled) noexcept;
+// reads datagrams which may have been coalesced. the buffer then holds several datagrams of segment_size_out each,
+// the last of which may be shorter. reads which do not fit in the buffer are dropped, and the next one is read instead.
+[[nodiscard]] looper::error read_segmented(const udp* udp, uint8_t* buffer, size_t buffer_size, size_t& read_out, size_t& segment_size_out, inet_endpoint& sender_out) noexcept;
+// receives up to count datagrams with a single call. if none are available, error_again is returned.
+[[nodiscard]] looper::error read_many(const udp* udp, datagram* datagrams, size_t count, size_t& read_count_out) noexcept;
+[[nodiscard]] looper::error write(const udp* udp, const inet_endpoint& destination, const uint8_t* buffer, size_t size, size_t& written_out) noexcept;
+// sends up to count datagrams with a single call. sent_count_out may be less than count if
+// the socket buffer filled up or sending one of the datagrams failed.
+[[nodiscard]] looper::error write_many(const udp* udp, const outgoing_datagram* datagrams, size_t count, size_t& sent_count_out) noexcept;
 
 }
 
@@ -133,7 +204,8 @@ void close(file* file) noexcept;
 namespace poll {
 
 struct event_data {
-    os::descriptor descriptor;
+    // the value registered with the descriptor
+    uint64_t user_data;
     event_type events;
 };
 
@@ -142,10 +214,12 @@ struct poller;
 [[nodiscard]] looper::error create(poller** poller_out) noexcept;
 void close(const poller* poller) noexcept;
 
-[[nodiscard]] looper::error add(const poller* poller, os::descriptor descriptor, event_type events) noexcept;
-[[nodiscard]] looper::error set(const poller* poller, os::descriptor descriptor, event_type events) noexcept;
+// user_data is reported back in event_data for events of the descriptor
+[[nodiscard]] looper::error add(const poller* poller, os::descriptor descriptor, event_type events, uint64_t user_data) noexcept;
+[[nodiscard]] looper::error set(const poller* poller, os::descriptor descriptor, event_type events, uint64_t user_data) noexcept;
 [[nodiscard]] looper::error remove(const poller* poller, os::descriptor descriptor) noexcept;
 
+// a negative timeout waits until an event occurs
 [[nodiscard]] looper::error poll(poller* poller, size_t max_events, std::chrono::milliseconds timeout, event_data* events, size_t& event_count) noexcept;
 
 }
@@ -7,7 +7,9 @@ enum class event_type : uint32_t {
     in = (0x1 << 0),
     out = (0x1 << 1),
     error = (0x1 << 2),
-    hung = (0x1 << 3)
+    hung = (0x1 << 3),
+    // not an event, marks the resource as edge-triggered when registered with the poller
+    edge = (0x1 << 4)
 };
 
 constexpr event_type operator~(const event_type lhs) {
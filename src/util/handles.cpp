@@ -3,16 +3,25 @@
 
 namespace looper::handles {
 
+static constexpr size_t type_shift = handle_parent_bits;
+static constexpr size_t parent_generation_shift = type_shift + handle_type_bits;
+static constexpr size_t index_shift = parent_generation_shift + handle_parent_generation_bits;
+static constexpr size_t generation_shift = index_shift + handle_index_bits;
+
 handle::handle(const handle_raw raw)
     : m_parent(0)
+    , m_parent_generation(0)
     , m_type(0)
-    , m_index(0) {
+    , m_index(0)
+    , m_generation(0) {
     this->raw(raw);
 }
-handle::handle(const uint8_t parent, const uint8_t type, const uint16_t index)
+handle::handle(const uint8_t parent, const uint8_t type, const uint32_t index, const uint32_t generation, const uint8_t parent_generation)
     : m_parent(parent)
+    , m_parent_generation(parent_generation)
     , m_type(type)
     , m_index(index)
+    , m_generation(generation)
 {}
 
 uint8_t handle::parent() const {
@@ -23,6 +32,14 @@ void handle::parent(const uint8_t parent) {
     m_parent = parent;
 }
 
+uint8_t handle::parent_generation() const {
+    return m_parent_generation;
+}
+
+void handle::parent_generation(const uint8_t parent_generation) {
+    m_parent_generation = parent_generation;
+}
+
 uint8_t handle::type() const {
     return m_type;
 }
@@ -31,22 +48,36 @@ void handle::type(const uint8_t type) {
     m_type = type;
 }
 
-uint16_t handle::index() const {
+uint32_t handle::index() const {
     return m_index;
 }
 
-void handle::index(const uint16_t index) {
+void handle::index(const uint32_t index) {
     m_index = index;
 }
 
+uint32_t handle::generation() const {
+    return m_generation;
+}
+
+void handle::generation(const uint32_t generation) {
+    m_generation = generation;
+}
+
 handle_raw handle::raw() const {
-    return (m_parent & 0xffff) | ((m_type & 0xffff) << 8) | ((m_index & 0xffffffff) << 16);
+    return static_cast<handle_raw>(m_parent & max_handle_parent) |
+        (static_cast<handle_raw>(m_type & handle_type_mask) << type_shift) |
+        (static_cast<handle_raw>(m_parent_generation & handle_parent_generation_mask) << parent_generation_shift) |
+        (static_cast<handle_raw>(m_index & max_handle_index) << index_shift) |
+        (static_cast<handle_raw>(m_generation & handle_generation_mask) << generation_shift);
 }
 
 void handle::raw(const handle_raw raw) {
-    m_parent = raw & 0xffff;
-    m_type = (raw >> 8) & 0xffff;
-    m_index = (raw >> 16) & 0xffffffff;
+    m_parent = raw & max_handle_parent;
+    m_type = (raw >> type_shift) & handle_type_mask;
+    m_parent_generation = (raw >> parent_generation_shift) & handle_parent_generation_mask;
+    m_index = (raw >> index_shift) & max_handle_index;
+    m_generation = (raw >> generation_shift) & handle_generation_mask;
 }
 
 }
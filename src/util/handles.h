@@ -2,7 +2,11 @@
 
 #include <cstddef>
 #include <memory>
+#include <optional>
+#include <type_traits>
 #include <iterator>
+#include <algorithm>
+#include <vector>
 
 #include <looper_types.h>
 #include <looper_except.h>
@@ -10,7 +14,27 @@
 namespace looper::handles {
 
 using handle_raw = looper::handle;
-static_assert(sizeof(handle_raw) >= sizeof(uint32_t));
+static_assert(sizeof(handle_raw) >= sizeof(uint64_t));
+
+// raw handle layout, from the lowest bit up:
+//   bits  0-5   parent (6 bits)
+//   bits  6-9   type (4 bits)
+//   bits 10-17  parent generation (8 bits)
+//   bits 18-39  index (22 bits)
+//   bits 40-63  generation (24 bits)
+static constexpr size_t handle_parent_bits = 6;
+static constexpr size_t handle_type_bits = 4;
+static constexpr size_t handle_parent_generation_bits = 8;
+static constexpr size_t handle_index_bits = 22;
+static constexpr size_t handle_generation_bits = 24;
+static_assert(handle_parent_bits + handle_type_bits + handle_parent_generation_bits +
+    handle_index_bits + handle_generation_bits <= sizeof(uint64_t) * 8);
+
+static constexpr uint32_t max_handle_parent = (1u << handle_parent_bits) - 1;
+static constexpr uint32_t handle_type_mask = (1u << handle_type_bits) - 1;
+static constexpr uint32_t handle_parent_generation_mask = (1u << handle_parent_generation_bits) - 1;
+static constexpr uint32_t max_handle_index = (1u << handle_index_bits) - 1;
+static constexpr uint32_t handle_generation_mask = (1u << handle_generation_bits) - 1;
 
 enum handle_types : uint8_t {
     type_loop = 0,
@@ -25,35 +49,56 @@ enum handle_types : uint8_t {
     type_unix_socket_server,
     type_max
 };
+static_assert(type_max <= handle_type_mask + 1);
 
+// the generation of a slot changes each time it is released, so handles to released objects
+// are detected as stale even once their slot is reused. the parent generation does the same
+// for the parent's slot, so handles of a destroyed parent are not mistaken for handles of a
+// new parent in the same slot.
 struct handle {
 public:
     explicit handle(handle_raw raw);
-    handle(uint8_t parent, uint8_t type, uint16_t index);
+    handle(uint8_t parent, uint8_t type, uint32_t index, uint32_t generation = 0, uint8_t parent_generation = 0);
 
     [[nodiscard]] uint8_t parent() const;
     void parent(uint8_t parent);
 
+    [[nodiscard]] uint8_t parent_generation() const;
+    void parent_generation(uint8_t parent_generation);
+
     [[nodiscard]] uint8_t type() const;
     void type(uint8_t type);
 
-    [[nodiscard]] uint16_t index() const;
-    void index(uint16_t index);
+    [[nodiscard]] uint32_t index() const;
+    void index(uint32_t index);
+
+    [[nodiscard]] uint32_t generation() const;
+    void generation(uint32_t generation);
 
     [[nodiscard]] handle_raw raw() const;
     void raw(handle_raw raw);
 
 private:
     uint8_t m_parent;
+    uint8_t m_parent_generation;
     uint8_t m_type;
-    uint16_t m_index;
+    uint32_t m_index;
+    uint32_t m_generation;
 };
 
-template<typename type_, size_t capacity_>
+// maps handles to objects. storage grows in fixed-size chunks up to capacity, so only used
+// slots cost memory and growing never moves existing slots.
+// by default each object is allocated on its own and shared, so it may outlive its slot. with inline_,
+// objects are stored in the chunks themselves, so neighbouring objects are next to each other in memory.
+// such objects are only valid until released, and are moved out of the table by release.
+template<typename type_, size_t capacity_, bool inline_ = false>
 class handle_table {
 public:
-    static_assert(capacity_ < UINT16_MAX);
+    static_assert(capacity_ <= max_handle_index);
     static constexpr size_t capacity = capacity_ - 1;
+    static constexpr size_t chunk_size = std::min<size_t>(capacity, 256);
+
+    using storage = std::conditional_t<inline_, std::optional<type_>, std::shared_ptr<type_>>;
 
     struct iterator {
     public:
@@ -63,268 +108,360 @@ public:
         using pointer           = value_type*;
         using reference         = value_type&;
 
-        iterator(handle_table& table, std::shared_ptr<value_type>* ptr, size_t index);
+        iterator(handle_table& table, size_t index);
 
         std::pair<handle_raw, reference> operator*() const;
 
         iterator& operator++();
         iterator operator++(int);
 
-        friend bool operator== (const iterator& a, const iterator& b);
-        friend bool operator!= (const iterator& a, const iterator& b);
+        friend bool operator== (const iterator& a, const iterator& b) {
+            return a.m_index == b.m_index;
+        }
+        friend bool operator!= (const iterator& a, const iterator& b) {
+            return a.m_index != b.m_index;
+        }
 
     private:
         void iterate_to_next_element();
 
         handle_table& m_table;
-        std::shared_ptr<value_type>* m_ptr;
         size_t m_index;
     };
 
-    handle_table(uint8_t parent, uint8_t type);
+    // parent_generation is the generation of the parent's own handle, only its low bits are kept
+    handle_table(uint8_t parent, uint8_t type, uint32_t parent_generation = 0);
 
     [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t size() const;
     [[nodiscard]] bool has(handle_raw handle_raw) const;
 
     const type_& operator[](handle_raw handle_raw) const;
     type_& operator[](handle_raw handle_raw);
 
     template<typename... arg_>
-    [[nodiscard]] std::pair<handle_raw, std::shared_ptr<type_>> allocate_new(arg_&&... args);
+    [[nodiscard]] std::pair<handle_raw, std::shared_ptr<type_>> allocate_new(arg_&&... args) requires (!inline_);
     template<typename... arg_>
-    [[nodiscard]] std::pair<handle_raw, type_&> assign_new(arg_&&... args);
-    [[nodiscard]] handle_raw reserve() const;
+    std::pair<handle_raw, type_&> assign_new(arg_&&... args);
+    [[nodiscard]] handle_raw reserve();
 
-    std::pair<handle_raw, type_&> assign(handle_raw new_handle, std::shared_ptr<type_>&& ptr);
-    std::shared_ptr<type_> release(handle_raw handle_raw);
+    std::pair<handle_raw, type_&> assign(handle_raw new_handle, std::shared_ptr<type_>&& ptr) requires (!inline_);
+    storage release(handle_raw handle_raw);
     void clear();
 
     iterator begin();
     iterator end();
 
 private:
-    [[nodiscard]] ssize_t find_next_available_spot() const;
-    [[nodiscard]] handles::handle verify_handle(handle_raw handle_raw);
+    struct slot {
+        storage data;
+        uint32_t generation;
+        // the index is in m_free_spots. it may remain there after the slot was taken, see take_spot.
+        bool free_listed;
+    };
+
+    [[nodiscard]] slot& slot_at(size_t index);
+    [[nodiscard]] const slot& slot_at(size_t index) const;
+
+    [[nodiscard]] ssize_t find_next_available_spot();
+    void take_spot(uint32_t index);
+    void push_free_spot(uint32_t index);
+    [[nodiscard]] handles::handle verify_handle(handle_raw handle_raw) const;
     [[nodiscard]] handles::handle valid_handle_for_us(handle_raw handle_raw) const;
 
     uint8_t m_parent;
+    uint8_t m_parent_generation;
     uint8_t m_type;
-    std::shared_ptr<type_> m_data[capacity];
+    std::vector<std::unique_ptr<slot[]>> m_chunks;
+    // amount of slots in allocated chunks
+    size_t m_slot_count;
+    // stack of unused slot indices. the next allocated slot is at the back. may also hold indices of
+    // slots taken since, which are dropped once they reach the back.
+    std::vector<uint32_t> m_free_spots;
     size_t m_count;
 };
 
-template<typename type_, size_t capacity_>
-handle_table<type_, capacity_>::handle_table(const uint8_t parent, const uint8_t type)
+template<typename type_, size_t capacity_, bool inline_>
+handle_table<type_, capacity_, inline_>::handle_table(const uint8_t parent, const uint8_t type, const uint32_t parent_generation)
     : m_parent(parent)
+    , m_parent_generation(static_cast<uint8_t>(parent_generation & handle_parent_generation_mask))
     , m_type(type)
-    , m_data()
+    , m_chunks()
+    , m_slot_count(0)
+    , m_free_spots()
     , m_count(0)
 {}
 
-template<typename type_, size_t capacity_>
-bool handle_table<type_, capacity_>::empty() const {
+template<typename type_, size_t capacity_, bool inline_>
+bool handle_table<type_, capacity_, inline_>::empty() const {
     return m_count < 1;
 }
 
-template<typename type_, size_t capacity_>
-bool handle_table<type_, capacity_>::has(const handle_raw handle_raw) const {
+template<typename type_, size_t capacity_, bool inline_>
+size_t handle_table<type_, capacity_, inline_>::size() const {
+    return m_count;
+}
+
+template<typename type_, size_t capacity_, bool inline_>
+bool handle_table<type_, capacity_, inline_>::has(const handle_raw handle_raw) const {
     if (handle_raw == empty_handle) {
         return false;
     }
 
     const handles::handle handle(handle_raw);
-    if (handle.parent() != m_parent || handle.type() != m_type || handle.index() >= capacity) {
+    if (handle.parent() != m_parent || handle.type() != m_type || handle.index() >= m_slot_count) {
         return false;
     }
 
-    if (m_data[handle.index()]) {
+    const auto& slot = slot_at(handle.index());
+    if (slot.data && slot.generation == handle.generation() && handle.parent_generation() == m_parent_generation) {
         return true;
     } else {
         return false;
     }
 }
 
-template<typename type_, size_t capacity_>
-const type_& handle_table<type_, capacity_>::operator[](handle_raw handle_raw) const {
+template<typename type_, size_t capacity_, bool inline_>
+const type_& handle_table<type_, capacity_, inline_>::operator[](handle_raw handle_raw) const {
     const auto handle = verify_handle(handle_raw);
 
     const auto index = handle.index();
-    return *m_data[index].get();
+    return *slot_at(index).data;
 }
 
-template<typename type_, size_t capacity_>
-type_& handle_table<type_, capacity_>::operator[](const handle_raw handle_raw) {
+template<typename type_, size_t capacity_, bool inline_>
+type_& handle_table<type_, capacity_, inline_>::operator[](const handle_raw handle_raw) {
     const auto handle = verify_handle(handle_raw);
 
     const auto index = handle.index();
-    return *m_data[index].get();
+    return *slot_at(index).data;
 }
 
-template<typename type_, size_t capacity_>
+template<typename type_, size_t capacity_, bool inline_>
 template<typename... arg_>
-std::pair<handle_raw, std::shared_ptr<type_>> handle_table<type_, capacity_>::allocate_new(arg_&&... args) {
+std::pair<handle_raw, std::shared_ptr<type_>> handle_table<type_, capacity_, inline_>::allocate_new(arg_&&... args) requires (!inline_) {
     const auto spot = find_next_available_spot();
     if (spot < 0) {
         throw no_space_exception();
     }
 
-    const auto index = static_cast<uint16_t>(spot);
-    const handle handle(m_parent, m_type, index);
+    const auto index = static_cast<uint32_t>(spot);
+    const handle handle(m_parent, m_type, index, slot_at(index).generation, m_parent_generation);
     const auto handle_raw = handle.raw();
 
     auto data = std::make_unique<type_>(handle_raw, std::forward<arg_>(args)...);
     return {handle_raw, std::move(data)};
 }
 
-template<typename type_, size_t capacity_>
+template<typename type_, size_t capacity_, bool inline_>
 template<typename... arg_>
-std::pair<handle_raw, type_&> handle_table<type_, capacity_>::assign_new(arg_&&... args) {
-    auto [handle, data] = this->allocate_new(std::forward<arg_>(args)...);
-    return assign(handle, std::move(data));
+std::pair<handle_raw, type_&> handle_table<type_, capacity_, inline_>::assign_new(arg_&&... args) {
+    if constexpr (inline_) {
+        const auto handle_raw = reserve();
+        const auto index = handle(handle_raw).index();
+        auto& slot = slot_at(index);
+
+        slot.data.emplace(handle_raw, std::forward<arg_>(args)...);
+        take_spot(index);
+        m_count++;
+
+        return {handle_raw, *slot.data};
+    } else {
+        auto [handle, data] = this->allocate_new(std::forward<arg_>(args)...);
+        return assign(handle, std::move(data));
+    }
 }
 
-template<typename type_, size_t capacity_>
-[[nodiscard]] handle_raw handle_table<type_, capacity_>::reserve() const {
+template<typename type_, size_t capacity_, bool inline_>
+[[nodiscard]] handle_raw handle_table<type_, capacity_, inline_>::reserve() {
     const auto spot = find_next_available_spot();
     if (spot < 0) {
         throw no_space_exception();
     }
 
-    const auto index = static_cast<uint16_t>(spot);
-    const handle handle(m_parent, m_type, index);
+    const auto index = static_cast<uint32_t>(spot);
+    const handle handle(m_parent, m_type, index, slot_at(index).generation, m_parent_generation);
     return handle.raw();
 }
 
-template<typename type_, size_t capacity_>
-std::pair<handle_raw, type_&> handle_table<type_, capacity_>::assign(const handle_raw new_handle, std::shared_ptr<type_>&& ptr) {
+template<typename type_, size_t capacity_, bool inline_>
+std::pair<handle_raw, type_&> handle_table<type_, capacity_, inline_>::assign(const handle_raw new_handle, std::shared_ptr<type_>&& ptr) requires (!inline_) {
     const auto handle = valid_handle_for_us(new_handle);
     auto index = handle.index();
+    auto& slot = slot_at(index);
 
-    if (m_data[index]) {
+    if (slot.data) {
         throw no_space_exception();
     }
+    if (slot.generation != handle.generation() || handle.parent_generation() != m_parent_generation) {
+        throw no_such_handle_exception(new_handle);
+    }
 
-    m_data[index] = std::move(ptr);
+    take_spot(index);
+    slot.data = std::move(ptr);
     m_count++;
 
-    auto data = m_data[index].get();
-    return {handle.raw(), reinterpret_cast<type_&>(*data)};
+    return {handle.raw(), *slot.data};
 }
 
-template<typename type_, size_t capacity_>
-std::shared_ptr<type_> handle_table<type_, capacity_>::release(const handle_raw handle_raw) {
+template<typename type_, size_t capacity_, bool inline_>
+handle_table<type_, capacity_, inline_>::storage handle_table<type_, capacity_, inline_>::release(const handle_raw handle_raw) {
     const auto handle = verify_handle(handle_raw);
 
     const auto index = handle.index();
+    auto& slot = slot_at(index);
 
-    std::shared_ptr<type_> data;
-    m_data[index].swap(data);
+    storage data;
+    slot.data.swap(data);
     m_count--;
 
+    slot.generation = (slot.generation + 1) & handle_generation_mask;
+    push_free_spot(index);
+
     return std::move(data);
 }
 
-template<typename type_, size_t capacity_>
-void handle_table<type_, capacity_>::clear() {
-    for (int i = 0; i < capacity; ++i) {
-        m_data[i].reset();
+template<typename type_, size_t capacity_, bool inline_>
+void handle_table<type_, capacity_, inline_>::clear() {
+    for (size_t i = 0; i < m_slot_count; ++i) {
+        auto& slot = slot_at(i);
+        if (slot.data) {
+            slot.data.reset();
+            slot.generation = (slot.generation + 1) & handle_generation_mask;
+            push_free_spot(static_cast<uint32_t>(i));
+        }
     }
 
     m_count = 0;
 }
 
-template<typename type_, size_t capacity_>
-handle_table<type_, capacity_>::iterator handle_table<type_, capacity_>::begin() {
-    return iterator(*this, &m_data[0], 0);
+template<typename type_, size_t capacity_, bool inline_>
+handle_table<type_, capacity_, inline_>::iterator handle_table<type_, capacity_, inline_>::begin() {
+    return iterator(*this, 0);
+}
+
+template<typename type_, size_t capacity_, bool inline_>
+handle_table<type_, capacity_, inline_>::iterator handle_table<type_, capacity_, inline_>::end()   {
+    return iterator(*this, m_slot_count);
+}
+
+template<typename type_, size_t capacity_, bool inline_>
+handle_table<type_, capacity_, inline_>::slot& handle_table<type_, capacity_, inline_>::slot_at(const size_t index) {
+    return m_chunks[index / chunk_size][index % chunk_size];
 }
 
-template<typename type_, size_t capacity_>
-handle_table<type_, capacity_>::iterator handle_table<type_, capacity_>::end()   {
-    return iterator(*this, &m_data[capacity], capacity);
+template<typename type_, size_t capacity_, bool inline_>
+const handle_table<type_, capacity_, inline_>::slot& handle_table<type_, capacity_, inline_>::slot_at(const size_t index) const {
+    return m_chunks[index / chunk_size][index % chunk_size];
 }
 
-template<typename type_, size_t capacity_>
-ssize_t handle_table<type_, capacity_>::find_next_available_spot() const {
-    for (int i = 0; i < capacity; ++i) {
-        if (!m_data[i]) {
-            return i;
+template<typename type_, size_t capacity_, bool inline_>
+ssize_t handle_table<type_, capacity_, inline_>::find_next_available_spot() {
+    // drop spots which were taken while not at the back
+    while (!m_free_spots.empty() && slot_at(m_free_spots.back()).data) {
+        slot_at(m_free_spots.back()).free_listed = false;
+        m_free_spots.pop_back();
+    }
+
+    if (m_free_spots.empty()) {
+        if (m_slot_count >= capacity) {
+            return -1;
         }
+
+        // grow by another chunk, existing chunks are untouched
+        const auto new_slots = std::min(chunk_size, capacity - m_slot_count);
+        m_chunks.push_back(std::make_unique<slot[]>(chunk_size));
+        // lowest indices are allocated first
+        for (size_t i = m_slot_count + new_slots; i > m_slot_count; --i) {
+            push_free_spot(static_cast<uint32_t>(i - 1));
+        }
+        m_slot_count += new_slots;
+    }
+
+    return m_free_spots.back();
+}
+
+template<typename type_, size_t capacity_, bool inline_>
+void handle_table<type_, capacity_, inline_>::take_spot(const uint32_t index) {
+    // the spot is almost always the one handed out last by allocate_new/reserve, which is at the back.
+    // otherwise it is left in place rather than searched for, and dropped by find_next_available_spot
+    // once it reaches the back, as its slot is then in use.
+    if (!m_free_spots.empty() && m_free_spots.back() == index) {
+        slot_at(index).free_listed = false;
+        m_free_spots.pop_back();
     }
+}
 
-    return -1;
+template<typename type_, size_t capacity_, bool inline_>
+void handle_table<type_, capacity_, inline_>::push_free_spot(const uint32_t index) {
+    // a spot taken while not at the back may still be listed, and must not be listed twice
+    auto& slot = slot_at(index);
+    if (!slot.free_listed) {
+        slot.free_listed = true;
+        m_free_spots.push_back(index);
+    }
 }
 
-template<typename type_, size_t capacity_>
-handles::handle handle_table<type_, capacity_>::verify_handle(const handle_raw handle_raw) {
+template<typename type_, size_t capacity_, bool inline_>
+handles::handle handle_table<type_, capacity_, inline_>::verify_handle(const handle_raw handle_raw) const {
     const auto handle = valid_handle_for_us(handle_raw);
 
-    if (!m_data[handle.index()]) {
+    const auto& slot = slot_at(handle.index());
+    if (!slot.data || slot.generation != handle.generation() || handle.parent_generation() != m_parent_generation) {
         throw no_such_handle_exception(handle_raw);
     }
 
     return handle;
 }
 
-template<typename type_, size_t capacity_>
-handles::handle handle_table<type_, capacity_>::valid_handle_for_us(const handle_raw handle_raw) const {
+template<typename type_, size_t capacity_, bool inline_>
+handles::handle handle_table<type_, capacity_, inline_>::valid_handle_for_us(const handle_raw handle_raw) const {
     const handles::handle handle(handle_raw);
 
-    if (handle.parent() != m_parent || handle.type() != m_type || handle.index() >= capacity) {
+    if (handle.parent() != m_parent || handle.type() != m_type || handle.index() >= m_slot_count) {
         throw bad_handle_exception(handle_raw);
     }
 
     return handle;
 }
 
-template<typename type_, size_t capacity_>
-handle_table<type_, capacity_>::iterator::iterator(
+template<typename type_, size_t capacity_, bool inline_>
+handle_table<type_, capacity_, inline_>::iterator::iterator(
     handle_table& table,
-    std::shared_ptr<value_type>* ptr,
     const size_t index)
     : m_table(table)
-    , m_ptr(ptr)
     , m_index(index) {
 
-    if (!m_ptr[m_index] && m_index < capacity) {
+    if (m_index < m_table.m_slot_count && !m_table.slot_at(m_index).data) {
         iterate_to_next_element();
     }
 }
 
-template<typename type_, size_t capacity_>
-std::pair<handle_raw, typename handle_table<type_, capacity_>::iterator::reference> handle_table<type_, capacity_>::iterator::operator*() const {
-    const handle handle(m_table.m_parent, m_table.m_type, m_index);
-    auto data = m_ptr[m_index].get();
-    return {handle.raw(), *data};
+template<typename type_, size_t capacity_, bool inline_>
+std::pair<handle_raw, typename handle_table<type_, capacity_, inline_>::iterator::reference> handle_table<type_, capacity_, inline_>::iterator::operator*() const {
+    auto& slot = m_table.slot_at(m_index);
+    const handle handle(m_table.m_parent, m_table.m_type, m_index, slot.generation, m_table.m_parent_generation);
+    return {handle.raw(), *slot.data};
 }
 
-template<typename type_, size_t capacity_>
-handle_table<type_, capacity_>::iterator& handle_table<type_, capacity_>::iterator::operator++() {
+template<typename type_, size_t capacity_, bool inline_>
+handle_table<type_, capacity_, inline_>::iterator& handle_table<type_, capacity_, inline_>::iterator::operator++() {
     iterate_to_next_element();
     return *this;
 }
 
-template<typename type_, size_t capacity_>
-handle_table<type_, capacity_>::iterator handle_table<type_, capacity_>::iterator::operator++(int) {
+template<typename type_, size_t capacity_, bool inline_>
+handle_table<type_, capacity_, inline_>::iterator handle_table<type_, capacity_, inline_>::iterator::operator++(int) {
     iterator tmp = *this;
     ++(*this);
     return tmp;
 }
 
-template<typename type_, size_t capacity_>
-bool operator== (const typename handle_table<type_, capacity_>::iterator& a, const typename handle_table<type_, capacity_>::iterator& b) {
-    return a.m_index == b.m_index;
-}
-
-template<typename type_, size_t capacity_>
-bool operator!= (const typename handle_table<type_, capacity_>::iterator& a, const typename handle_table<type_, capacity_>::iterator& b) {
-    return a.m_index != b.m_index;
-}
-
-template<typename type_, size_t capacity_>
-void handle_table<type_, capacity_>::iterator::iterate_to_next_element() {
+template<typename type_, size_t capacity_, bool inline_>
+void handle_table<type_, capacity_, inline_>::iterator::iterate_to_next_element() {
     do {
         m_index++;
-    } while (!m_ptr[m_index] && m_index < capacity);
+    } while (m_index < m_table.m_slot_count && !m_table.slot_at(m_index).data);
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <concepts>
+
+namespace looper::util {
+
+static constexpr size_t heap_npos = static_cast<size_t>(-1);
+
+template<typename t_>
+concept heap_node_type = requires(t_ t) {
+    { t.heap_index } -> std::convertible_to<size_t>;
+};
+
+template<typename t_, typename node_t_>
+concept heap_compare_type = requires(t_ t, const node_t_* a, const node_t_* b) {
+    { t(a, b) } -> std::same_as<bool>;
+};
+
+// 4-ary min-heap of intrusive nodes. each node stores its own position in the heap (heap_index), allowing
+// removal and re-keying of arbitrary nodes in O(log n) without searching for them.
+// nodes are not owned by the heap and must outlive their membership in it.
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+class intrusive_heap {
+public:
+    static constexpr size_t arity = 4;
+
+    intrusive_heap();
+
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool contains(const t_* node) const;
+    [[nodiscard]] t_* top() const;
+
+    void push(t_* node);
+    t_* pop();
+    void remove(t_* node);
+    // must be called after the key of a node already in the heap was modified
+    void update(t_* node);
+    void clear();
+
+    // visits nodes from the top of the heap downwards. if the visitor returns false for a node,
+    // its children are not visited. as children are never ordered before their parent, this allows
+    // visiting only the nodes ordered before some bound. the visitor must not visit the heap again.
+    template<typename visitor_>
+    void visit(visitor_&& visitor) const;
+
+private:
+    void sift_up(size_t index);
+    void sift_down(size_t index);
+    void place(size_t index, t_* node);
+
+    std::vector<t_*> m_nodes;
+    // scratch stack for visit, kept to avoid allocating on every call
+    mutable std::vector<size_t> m_visit_pending;
+};
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+intrusive_heap<t_, compare_>::intrusive_heap()
+    : m_nodes()
+    , m_visit_pending()
+{}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+bool intrusive_heap<t_, compare_>::empty() const {
+    return m_nodes.empty();
+}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+size_t intrusive_heap<t_, compare_>::size() const {
+    return m_nodes.size();
+}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+bool intrusive_heap<t_, compare_>::contains(const t_* node) const {
+    return node->heap_index < m_nodes.size() && m_nodes[node->heap_index] == node;
+}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+t_* intrusive_heap<t_, compare_>::top() const {
+    if (m_nodes.empty()) {
+        return nullptr;
+    }
+
+    return m_nodes.front();
+}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+void intrusive_heap<t_, compare_>::push(t_* node) {
+    if (contains(node)) {
+        update(node);
+        return;
+    }
+
+    m_nodes.push_back(node);
+    node->heap_index = m_nodes.size() - 1;
+    sift_up(node->heap_index);
+}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+t_* intrusive_heap<t_, compare_>::pop() {
+    if (m_nodes.empty()) {
+        return nullptr;
+    }
+
+    auto* node = m_nodes.front();
+    remove(node);
+    return node;
+}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+void intrusive_heap<t_, compare_>::remove(t_* node) {
+    if (!contains(node)) {
+        return;
+    }
+
+    const auto index = node->heap_index;
+    auto* last = m_nodes.back();
+    m_nodes.pop_back();
+    node->heap_index = heap_npos;
+
+    if (last != node) {
+        place(index, last);
+        update(last);
+    }
+}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+void intrusive_heap<t_, compare_>::update(t_* node) {
+    const auto index = node->heap_index;
+    if (index > 0 && compare_()(node, m_nodes[(index - 1) / arity])) {
+        sift_up(index);
+    } else {
+        sift_down(index);
+    }
+}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+void intrusive_heap<t_, compare_>::clear() {
+    for (auto* node : m_nodes) {
+        node->heap_index = heap_npos;
+    }
+
+    m_nodes.clear();
+}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+template<typename visitor_>
+void intrusive_heap<t_, compare_>::visit(visitor_&& visitor) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    auto& pending = m_visit_pending;
+    pending.clear();
+    pending.push_back(0);
+    while (!pending.empty()) {
+        const auto index = pending.back();
+        pending.pop_back();
+
+        if (!visitor(static_cast<const t_*>(m_nodes[index]))) {
+            continue;
+        }
+
+        const auto first_child = index * arity + 1;
+        const auto last_child = std::min(first_child + arity, m_nodes.size());
+        for (auto child = first_child; child < last_child; ++child) {
+            pending.push_back(child);
+        }
+    }
+}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+void intrusive_heap<t_, compare_>::sift_up(size_t index) {
+    auto* node = m_nodes[index];
+    while (index > 0) {
+        const auto parent = (index - 1) / arity;
+        if (!compare_()(node, m_nodes[parent])) {
+            break;
+        }
+
+        place(index, m_nodes[parent]);
+        index = parent;
+    }
+
+    place(index, node);
+}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+void intrusive_heap<t_, compare_>::sift_down(size_t index) {
+    auto* node = m_nodes[index];
+    const auto count = m_nodes.size();
+
+    while (true) {
+        const auto first_child = index * arity + 1;
+        if (first_child >= count) {
+            break;
+        }
+
+        auto smallest = first_child;
+        const auto last_child = std::min(first_child + arity, count);
+        for (auto child = first_child + 1; child < last_child; ++child) {
+            if (compare_()(m_nodes[child], m_nodes[smallest])) {
+                smallest = child;
+            }
+        }
+
+        if (!compare_()(m_nodes[smallest], node)) {
+            break;
+        }
+
+        place(index, m_nodes[smallest]);
+        index = smallest;
+    }
+
+    place(index, node);
+}
+
+template<heap_node_type t_, heap_compare_type<t_> compare_>
+void intrusive_heap<t_, compare_>::place(const size_t index, t_* node) {
+    m_nodes[index] = node;
+    node->heap_index = index;
+}
+
+}
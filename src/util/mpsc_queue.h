@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+
+namespace looper::util {
+
+struct mpsc_node {
+    mpsc_node()
+        : mpsc_next(nullptr)
+    {}
+
+    std::atomic<mpsc_node*> mpsc_next;
+};
+
+template<typename t_>
+concept mpsc_node_type = std::derived_from<t_, mpsc_node>;
+
+// lock-free intrusive multi-producer single-consumer queue (based on Dmitry Vyukov's design).
+// push may be called from any thread, while pop and empty may only be called by a single consumer
+// at a time. nodes are not owned by the queue and must outlive their membership in it.
+// pop may spuriously report no node while a producer is mid-push, in which case the node will be
+// available once that push completes.
+template<mpsc_node_type t_>
+class mpsc_queue {
+public:
+    mpsc_queue();
+
+    mpsc_queue(mpsc_queue&) = delete;
+    mpsc_queue(mpsc_queue&&) = delete;
+    mpsc_queue& operator=(mpsc_queue&) = delete;
+    mpsc_queue& operator=(mpsc_queue&&) = delete;
+
+    void push(t_* node);
+    t_* pop();
+    [[nodiscard]] bool empty() const;
+
+private:
+    void push_node(mpsc_node* node);
+
+    std::atomic<mpsc_node*> m_head;
+    mpsc_node* m_tail;
+    mpsc_node m_stub;
+};
+
+template<mpsc_node_type t_>
+mpsc_queue<t_>::mpsc_queue()
+    : m_head(&m_stub)
+    , m_tail(&m_stub)
+    , m_stub()
+{}
+
+template<mpsc_node_type t_>
+void mpsc_queue<t_>::push(t_* node) {
+    push_node(node);
+}
+
+template<mpsc_node_type t_>
+t_* mpsc_queue<t_>::pop() {
+    auto* tail = m_tail;
+    auto* next = tail->mpsc_next.load(std::memory_order_acquire);
+
+    if (tail == &m_stub) {
+        if (next == nullptr) {
+            return nullptr;
+        }
+
+        m_tail = next;
+        tail = next;
+        next = next->mpsc_next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr) {
+        m_tail = next;
+        return static_cast<t_*>(tail);
+    }
+
+    if (tail != m_head.load(std::memory_order_acquire)) {
+        // a producer is in the middle of pushing after tail
+        return nullptr;
+    }
+
+    // tail is the last node, put the stub behind it so it can be detached
+    push_node(&m_stub);
+
+    next = tail->mpsc_next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+        m_tail = next;
+        return static_cast<t_*>(tail);
+    }
+
+    return nullptr;
+}
+
+template<mpsc_node_type t_>
+bool mpsc_queue<t_>::empty() const {
+    return m_tail == &m_stub && m_head.load(std::memory_order_acquire) == &m_stub;
+}
+
+template<mpsc_node_type t_>
+void mpsc_queue<t_>::push_node(mpsc_node* node) {
+    node->mpsc_next.store(nullptr, std::memory_order_relaxed);
+    auto* prev = m_head.exchange(node, std::memory_order_acq_rel);
+    prev->mpsc_next.store(node, std::memory_order_release);
+}
+
+}
@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "test.h"
+
+namespace looper::tests {
+
+struct test_case {
+    std::string suite;
+    std::string name;
+    test_func func;
+};
+
+static std::vector<test_case>& get_test_cases() {
+    static std::vector<test_case> g_cases;
+    return g_cases;
+}
+
+check_failed::check_failed(const char* file, const int line, const char* expression)
+    : m_message() {
+    snprintf(m_message, sizeof(m_message), "%s:%d: check failed: %s", file, line, expression);
+}
+
+const char* check_failed::what() const noexcept {
+    return m_message;
+}
+
+test_skipped::test_skipped(const char* reason)
+    : m_reason(reason)
+{}
+
+const char* test_skipped::what() const noexcept {
+    return m_reason;
+}
+
+registrar::registrar(const std::string_view suite, const std::string_view name, const test_func func) {
+    get_test_cases().push_back({std::string(suite), std::string(name), func});
+}
+
+}
+
+// reported to ctest when all the tests that ran were skipped, see SKIP_RETURN_CODE in tests/CMakeLists.txt
+static constexpr int skipped_exit_code = 77;
+
+// usage: looper_tests [suite]. runs all the tests of the suite, or all tests if none is given.
+int main(const int argc, const char** argv) {
+    const std::string_view suite = argc > 1 ? argv[1] : "";
+
+    size_t ran = 0;
+    size_t failed = 0;
+    size_t skipped = 0;
+    for (const auto& test : looper::tests::get_test_cases()) {
+        if (!suite.empty() && test.suite != suite) {
+            continue;
+        }
+
+        printf("[ RUN  ] %s.%s\n", test.suite.c_str(), test.name.c_str());
+        fflush(stdout);
+        ran++;
+
+        try {
+            test.func();
+            printf("[  OK  ] %s.%s\n", test.suite.c_str(), test.name.c_str());
+        } catch (const looper::tests::test_skipped& e) {
+            printf("[ SKIP ] %s.%s: %s\n", test.suite.c_str(), test.name.c_str(), e.what());
+            skipped++;
+        } catch (const std::exception& e) {
+            printf("[ FAIL ] %s.%s: %s\n", test.suite.c_str(), test.name.c_str(), e.what());
+            failed++;
+        }
+        fflush(stdout);
+    }
+
+    if (ran == 0) {
+        printf("no tests found for suite '%s'\n", std::string(suite).c_str());
+        return 1;
+    }
+
+    printf("%lu tests ran, %lu failed, %lu skipped\n", ran, failed, skipped);
+    if (failed != 0) {
+        return 1;
+    }
+
+    return skipped == ran ? skipped_exit_code : 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <exception>
+#include <string_view>
+#include <thread>
+
+// minimal test harness. tests register themselves under a suite, and each suite is run as
+// a separate ctest test, see tests/CMakeLists.txt.
+
+namespace looper::tests {
+
+using test_func = void(*)();
+
+class check_failed final : public std::exception {
+public:
+    check_failed(const char* file, int line, const char* expression);
+
+    [[nodiscard]] const char* what() const noexcept override;
+
+private:
+    char m_message[512];
+};
+
+// thrown by SKIP, when the test cannot run in this environment
+class test_skipped final : public std::exception {
+public:
+    explicit test_skipped(const char* reason);
+
+    [[nodiscard]] const char* what() const noexcept override;
+
+private:
+    const char* m_reason;
+};
+
+struct registrar {
+    registrar(std::string_view suite, std::string_view name, test_func func);
+};
+
+// checks in callbacks running in a loop thread should only record results, as exceptions
+// thrown there do not reach the test.
+template<typename pred_>
+bool wait_for(pred_&& pred, const std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+    const auto end = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() >= end) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+}
+
+}
+
+#define LOOPER_TEST(suite, name) \
+    static void suite##_##name(); \
+    static const ::looper::tests::registrar suite##_##name##_registrar(#suite, #name, suite##_##name); \
+    static void suite##_##name()
+
+#define CHECK(expression) \
+    do { \
+        if (!(expression)) { \
+            throw ::looper::tests::check_failed(__FILE__, __LINE__, #expression); \
+        } \
+    } while (false)
+
+#define CHECK_THROWS(expression, exception_type) \
+    do { \
+        bool thrown_ = false; \
+        try { \
+            expression; \
+        } catch (const exception_type&) { \
+            thrown_ = true; \
+        } \
+        if (!thrown_) { \
+            throw ::looper::tests::check_failed(__FILE__, __LINE__, #expression " throws " #exception_type); \
+        } \
+    } while (false)
+
+#define SKIP(reason) \
+    throw ::looper::tests::test_skipped(reason)
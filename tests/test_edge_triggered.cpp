@@ -0,0 +1,226 @@
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <looper.h>
+
+#include "test.h"
+
+using namespace std::chrono_literals;
+
+static constexpr uint16_t tcp_port = 47401;
+static constexpr uint16_t udp_port = 47402;
+static constexpr uint16_t provider_udp_port = 47403;
+static constexpr uint16_t empty_udp_port = 47404;
+static constexpr size_t read_buffer_size = 1024;
+
+static looper::loop create_edge_triggered_loop() {
+    looper::loop_options options{};
+    options.edge_triggered_io = true;
+    // small reads, so draining a socket takes many of them
+    options.read_buffer_size = read_buffer_size;
+    return looper::create(options);
+}
+
+static sockaddr_in loopback_address(const uint16_t port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+}
+
+template<typename pred_>
+static bool run_until(const looper::loop loop, pred_&& pred) {
+    for (int i = 0; i < 200 && !pred(); i++) {
+        looper::run_for(loop, 10ms);
+    }
+
+    return pred();
+}
+
+// data that arrived in a single edge must all be read, even when it takes more reads than
+// are done in one loop iteration.
+LOOPER_TEST(edge_triggered, tcp_reads_drain_socket) {
+    constexpr size_t total = 64 * 1024;
+
+    const auto loop = create_edge_triggered_loop();
+
+    size_t received = 0;
+    size_t reads = 0;
+    bool failed = false;
+    looper::tcp accepted = looper::empty_handle;
+
+    const auto server = looper::create_tcp_server(loop);
+    looper::bind_tcp_server(server, "127.0.0.1", tcp_port);
+    looper::listen_tcp(server, 1, [&](const looper::tcp_server tcp_server) {
+        accepted = looper::accept_tcp(tcp_server);
+        looper::start_tcp_read(accepted, [&](looper::handle, const std::span<const uint8_t> data, const looper::error error) {
+            if (error != looper::error_success) {
+                failed = true;
+                return;
+            }
+
+            received += data.size();
+            reads++;
+        });
+    });
+
+    const auto client = socket(AF_INET, SOCK_STREAM, 0);
+    CHECK(client >= 0);
+    const auto address = loopback_address(tcp_port);
+    CHECK(connect(client, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+    CHECK(run_until(loop, [&]()->bool { return accepted != looper::empty_handle; }));
+
+    const std::vector<uint8_t> data(total, 0x5a);
+    CHECK(send(client, data.data(), data.size(), 0) == static_cast<ssize_t>(data.size()));
+
+    CHECK(run_until(loop, [&]()->bool { return received == total || failed; }));
+    CHECK(!failed);
+    CHECK(received == total);
+    CHECK(reads >= total / read_buffer_size);
+
+    close(client);
+    looper::destroy_tcp(accepted);
+    looper::destroy_tcp_server(server);
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(edge_triggered, udp_reads_drain_socket) {
+    constexpr size_t count = 100;
+
+    const auto loop = create_edge_triggered_loop();
+
+    size_t received = 0;
+    bool failed = false;
+
+    const auto udp = looper::create_udp(loop);
+    looper::bind_udp(udp, udp_port);
+    looper::start_udp_read_endpoint(udp, [&](looper::udp, looper::inet_endpoint, const std::span<const uint8_t> data, const looper::error error) {
+        if (error != looper::error_success || data.size() != 32) {
+            failed = true;
+            return;
+        }
+
+        received++;
+    });
+
+    // all the datagrams are queued before the loop first sees the socket readable
+    const auto sender = socket(AF_INET, SOCK_DGRAM, 0);
+    CHECK(sender >= 0);
+    const auto address = loopback_address(udp_port);
+    uint8_t datagram[32];
+    memset(datagram, 0x5a, sizeof(datagram));
+    for (size_t i = 0; i < count; i++) {
+        CHECK(sendto(sender, datagram, sizeof(datagram), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) ==
+            sizeof(datagram));
+    }
+
+    CHECK(run_until(loop, [&]()->bool { return received == count || failed; }));
+    CHECK(!failed);
+    CHECK(received == count);
+
+    close(sender);
+    looper::destroy_udp(udp);
+    looper::destroy(loop);
+}
+
+// an empty datagram is read like any other, and must not be taken for a read which would block.
+// otherwise the datagrams queued behind it wait for an edge which may never come.
+LOOPER_TEST(edge_triggered, udp_empty_datagram_does_not_end_drain) {
+    constexpr size_t count = 10;
+
+    const auto loop = create_edge_triggered_loop();
+
+    size_t empty = 0;
+    size_t received = 0;
+    bool failed = false;
+
+    const auto udp = looper::create_udp(loop);
+    looper::bind_udp(udp, empty_udp_port);
+    looper::start_udp_read_endpoint(udp, [&](looper::udp, looper::inet_endpoint, const std::span<const uint8_t> data, const looper::error error) {
+        if (error != looper::error_success) {
+            failed = true;
+            return;
+        }
+
+        if (data.empty()) {
+            empty++;
+        } else {
+            received++;
+        }
+    });
+
+    // all the datagrams are queued behind the empty one before the loop first sees the socket readable
+    const auto sender = socket(AF_INET, SOCK_DGRAM, 0);
+    CHECK(sender >= 0);
+    const auto address = loopback_address(empty_udp_port);
+    CHECK(sendto(sender, nullptr, 0, 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+    uint8_t datagram[32];
+    memset(datagram, 0x5a, sizeof(datagram));
+    for (size_t i = 0; i < count; i++) {
+        CHECK(sendto(sender, datagram, sizeof(datagram), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) ==
+            sizeof(datagram));
+    }
+
+    CHECK(run_until(loop, [&]()->bool { return received == count || failed; }));
+    CHECK(!failed);
+    CHECK(empty == 1);
+    CHECK(received == count);
+
+    close(sender);
+    looper::destroy_udp(udp);
+    looper::destroy(loop);
+}
+
+// a read which would block gives no callback, so the buffer taken from the provider for it must
+// be used for the next read instead of being dropped.
+LOOPER_TEST(edge_triggered, provided_buffer_kept_when_read_would_block) {
+    constexpr size_t count = 10;
+
+    const auto loop = create_edge_triggered_loop();
+
+    std::vector<uint8_t> buffers[2] = {std::vector<uint8_t>(read_buffer_size), std::vector<uint8_t>(read_buffer_size)};
+    size_t provided = 0;
+    size_t received = 0;
+    bool failed = false;
+
+    const auto udp = looper::create_udp(loop);
+    looper::bind_udp(udp, provider_udp_port);
+    looper::start_udp_read_endpoint(udp, [&](looper::handle)->std::span<uint8_t> {
+        return buffers[provided++ % 2];
+    }, [&](looper::udp, looper::inet_endpoint, const std::span<const uint8_t> data, const looper::error error) {
+        if (error != looper::error_success || data.size() != 32 || data[0] != static_cast<uint8_t>(received)) {
+            failed = true;
+            return;
+        }
+
+        received++;
+    });
+
+    // each datagram is sent on its own, so each is followed by a read which would block
+    const auto sender = socket(AF_INET, SOCK_DGRAM, 0);
+    CHECK(sender >= 0);
+    const auto address = loopback_address(provider_udp_port);
+    uint8_t datagram[32];
+    for (size_t i = 0; i < count; i++) {
+        memset(datagram, static_cast<int>(i), sizeof(datagram));
+        CHECK(sendto(sender, datagram, sizeof(datagram), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) ==
+            sizeof(datagram));
+        CHECK(run_until(loop, [&]()->bool { return received == i + 1 || failed; }));
+    }
+
+    CHECK(!failed);
+    CHECK(received == count);
+    // one buffer per datagram, and one more held for the next datagram
+    CHECK(provided == count + 1);
+
+    close(sender);
+    looper::destroy_udp(udp);
+    looper::destroy(loop);
+}
@@ -0,0 +1,75 @@
+#include <chrono>
+#include <set>
+#include <vector>
+
+#include <looper.h>
+
+#include "test.h"
+
+using namespace std::chrono_literals;
+
+LOOPER_TEST(handles, many_objects_get_distinct_handles) {
+    // timers take no descriptors, so many of them can exist without hitting os limits
+    constexpr size_t count = 100000;
+
+    const auto loop = looper::create();
+
+    std::vector<looper::timer> timers;
+    timers.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        timers.push_back(looper::create_timer(loop, 1h, [](looper::timer) {}));
+    }
+
+    const std::set<looper::timer> unique(timers.begin(), timers.end());
+    CHECK(unique.size() == count);
+    for (const auto timer : timers) {
+        CHECK(looper::get_parent_loop(timer) == loop);
+    }
+
+    for (const auto timer : timers) {
+        looper::destroy_timer(timer);
+    }
+    for (const auto timer : timers) {
+        CHECK_THROWS(looper::destroy_timer(timer), looper::no_such_handle_exception);
+    }
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(handles, released_slot_gets_new_handle) {
+    const auto loop = looper::create();
+
+    const auto first = looper::create_timer(loop, 1h, [](looper::timer) {});
+    looper::destroy_timer(first);
+    const auto second = looper::create_timer(loop, 1h, [](looper::timer) {});
+
+    CHECK(first != second);
+    CHECK_THROWS(looper::start_timer(first), looper::no_such_handle_exception);
+    looper::start_timer(second);
+
+    looper::destroy_timer(second);
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(handles, handles_of_destroyed_loop_rejected_after_slot_reuse) {
+    const auto old_loop = looper::create();
+    const auto old_timer = looper::create_timer(old_loop, 1h, [](looper::timer) {});
+    const auto old_udp = looper::create_udp(old_loop);
+    looper::destroy(old_loop);
+
+    // the new loop takes the freed slot, and its objects the same slots in its tables
+    const auto new_loop = looper::create();
+    const auto new_timer = looper::create_timer(new_loop, 1h, [](looper::timer) {});
+    const auto new_udp = looper::create_udp(new_loop);
+
+    CHECK_THROWS(looper::start_timer(old_timer), looper::no_such_handle_exception);
+    CHECK_THROWS(looper::get_parent_loop(old_timer), looper::no_such_handle_exception);
+    CHECK_THROWS(looper::destroy_udp(old_udp), looper::no_such_handle_exception);
+
+    CHECK(looper::get_parent_loop(new_timer) == new_loop);
+    looper::start_timer(new_timer);
+    looper::destroy_timer(new_timer);
+    looper::destroy_udp(new_udp);
+
+    looper::destroy(new_loop);
+}
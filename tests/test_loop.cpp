@@ -0,0 +1,77 @@
+#include <atomic>
+#include <chrono>
+
+#include <looper.h>
+
+#include "test.h"
+
+using namespace std::chrono_literals;
+
+// objects are created, used and destroyed from another thread while the loop runs in its own thread.
+// the loop must neither fail to run while the other thread holds it, nor dispatch events to destroyed objects.
+LOOPER_TEST(loop, destroy_from_other_thread) {
+    constexpr size_t iterations = 10000;
+
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    for (size_t i = 0; i < iterations; i++) {
+        const auto event = looper::create_event(loop, [](looper::event) {});
+        looper::set_event(event);
+        looper::destroy_event(event);
+    }
+
+    std::atomic<bool> fired(false);
+    const auto event = looper::create_event(loop, [&](looper::event) {
+        fired.store(true);
+    });
+    looper::set_event(event);
+    CHECK(looper::tests::wait_for([&]()->bool { return fired.load(); }));
+
+    looper::destroy_event(event);
+    looper::destroy(loop);
+}
+
+// two events are ready in the same poll. the first one to run destroys the other and creates a new one, which
+// takes the released resource slot. the event still pending for the destroyed one carries the old generation
+// of the slot, so it must be dropped rather than dispatched to the new event.
+LOOPER_TEST(loop, event_of_destroyed_resource_not_dispatched_to_reused_slot) {
+    const auto loop = looper::create();
+
+    looper::event events[2] = {looper::empty_handle, looper::empty_handle};
+    looper::event reused = looper::empty_handle;
+    size_t fired = 0;
+    size_t reused_fired = 0;
+
+    for (size_t i = 0; i < 2; i++) {
+        events[i] = looper::create_event(loop, [&, i](looper::event event) {
+            fired++;
+            looper::clear_event(event);
+            if (reused != looper::empty_handle) {
+                return;
+            }
+
+            looper::destroy_event(events[1 - i]);
+            events[1 - i] = looper::empty_handle;
+            reused = looper::create_event(loop, [&](looper::event) {
+                reused_fired++;
+            });
+        });
+    }
+
+    looper::set_event(events[0]);
+    looper::set_event(events[1]);
+    looper::run_for(loop, 50ms);
+
+    CHECK(fired == 1);
+    CHECK(reused != looper::empty_handle);
+    CHECK(reused_fired == 0);
+
+    for (const auto event : events) {
+        if (event != looper::empty_handle) {
+            looper::destroy_event(event);
+        }
+    }
+    looper::destroy_event(reused);
+    looper::destroy(loop);
+}
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <looper.h>
+
+#include "test.h"
+
+using namespace std::chrono_literals;
+
+static constexpr uint16_t tcp_port = 47901;
+static constexpr uint16_t udp_sender_port = 47902;
+static constexpr uint16_t udp_receiver_port = 47903;
+
+template<typename pred_>
+static bool run_until(const looper::loop loop, pred_&& pred) {
+    for (int i = 0; i < 500 && !pred(); i++) {
+        looper::run_for(loop, 10ms);
+    }
+
+    return pred();
+}
+
+static std::vector<uint8_t> make_payload(const size_t size, const uint8_t seed) {
+    std::vector<uint8_t> payload(size);
+    for (size_t i = 0; i < size; i++) {
+        payload[i] = static_cast<uint8_t>(i * 13 + seed);
+    }
+    return payload;
+}
+
+static std::unique_ptr<uint8_t[]> make_unique_payload(const std::vector<uint8_t>& payload) {
+    auto buffer = std::make_unique<uint8_t[]>(payload.size());
+    std::copy(payload.begin(), payload.end(), buffer.get());
+    return buffer;
+}
+
+// a shared buffer which records when the last reference to it was released
+static looper::shared_buffer make_shared_payload(const std::vector<uint8_t>& payload, bool& released) {
+    auto* data = new uint8_t[payload.size()];
+    std::copy(payload.begin(), payload.end(), data);
+    return {data, [&released](const uint8_t* ptr) {
+        released = true;
+        delete[] ptr;
+    }};
+}
+
+// writes which take ownership of their buffer keep it until written, even though the caller let go of it
+// before the loop wrote it. these writes are queued behind one too large for the socket buffers, so they are
+// only written by the loop.
+LOOPER_TEST(owned_writes, tcp_buffers_outlive_caller) {
+    constexpr size_t large_size = 16 * 1024 * 1024;
+    constexpr size_t size = 4096;
+
+    const auto loop = looper::create();
+
+    std::vector<uint8_t> received;
+    looper::tcp accepted = looper::empty_handle;
+    const auto server = looper::create_tcp_server(loop);
+    looper::bind_tcp_server(server, "127.0.0.1", tcp_port);
+    looper::listen_tcp(server, 1, [&](const looper::tcp_server tcp_server) {
+        accepted = looper::accept_tcp(tcp_server);
+        looper::start_tcp_read(accepted, [&received](looper::handle, const std::span<const uint8_t> data, const looper::error error) {
+            if (error == looper::error_success) {
+                received.insert(received.end(), data.begin(), data.end());
+            }
+        });
+    });
+
+    bool connected = false;
+    const auto client = looper::create_tcp(loop);
+    looper::connect_tcp(client, "127.0.0.1", tcp_port, [&connected](looper::handle, const looper::error error) {
+        connected = error == looper::error_success;
+    });
+    CHECK(run_until(loop, [&]()->bool { return connected && accepted != looper::empty_handle; }));
+
+    const auto large = make_payload(large_size, 0);
+    const auto from_unique = make_payload(size, 1);
+    const auto from_vector = make_payload(size, 2);
+    const auto from_shared = make_payload(size, 3);
+
+    size_t written = 0;
+    bool failed = false;
+    bool shared_released = false;
+    bool shared_released_early = false;
+    const auto on_written = [&](looper::handle, const looper::error error) {
+        failed = failed || error != looper::error_success;
+        written++;
+    };
+
+    looper::write_tcp(client, std::span<const uint8_t>(large), on_written);
+    {
+        auto buffer = make_unique_payload(from_unique);
+        looper::write_tcp(client, std::move(buffer), size, on_written);
+    }
+    {
+        auto buffer = from_vector;
+        looper::write_tcp(client, std::move(buffer), on_written);
+    }
+    {
+        auto buffer = make_shared_payload(from_shared, shared_released);
+        looper::write_tcp(client, buffer, size, [&](looper::handle handle, const looper::error error) {
+            shared_released_early = shared_released;
+            on_written(handle, error);
+        });
+    }
+    CHECK(written == 0);
+    CHECK(!shared_released);
+
+    CHECK(run_until(loop, [&]()->bool { return written == 4 && received.size() == large_size + size * 3; }));
+    CHECK(!failed);
+    CHECK(!shared_released_early);
+    CHECK(run_until(loop, [&]()->bool { return shared_released; }));
+
+    std::vector<uint8_t> expected;
+    for (const auto* payload : {&large, &from_unique, &from_vector, &from_shared}) {
+        expected.insert(expected.end(), payload->begin(), payload->end());
+    }
+    CHECK(received == expected);
+
+    looper::destroy_tcp(client);
+    looper::destroy_tcp(accepted);
+    looper::destroy_tcp_server(server);
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(owned_writes, udp_buffers_outlive_caller) {
+    constexpr size_t size = 1024;
+
+    const auto loop = looper::create();
+
+    std::vector<std::vector<uint8_t>> received;
+    const auto receiver = looper::create_udp(loop);
+    looper::bind_udp(receiver, udp_receiver_port);
+    looper::start_udp_read(receiver, [&received](looper::udp, looper::inet_address_view, const std::span<const uint8_t> data, const looper::error error) {
+        if (error == looper::error_success) {
+            received.emplace_back(data.begin(), data.end());
+        }
+    });
+
+    const auto sender = looper::create_udp(loop);
+    looper::bind_udp(sender, udp_sender_port);
+
+    const auto destination = looper::make_inet_endpoint({"127.0.0.1", udp_receiver_port});
+    const auto from_unique = make_payload(size, 4);
+    const auto from_vector = make_payload(size, 5);
+    const auto from_shared = make_payload(size, 6);
+
+    size_t written = 0;
+    bool failed = false;
+    bool shared_released = false;
+    bool shared_released_early = false;
+    const auto on_written = [&](looper::udp, const looper::error error) {
+        failed = failed || error != looper::error_success;
+        written++;
+    };
+
+    {
+        auto buffer = make_unique_payload(from_unique);
+        looper::write_udp(sender, destination, std::move(buffer), size, on_written);
+    }
+    {
+        auto buffer = from_vector;
+        looper::write_udp(sender, destination, std::move(buffer), on_written);
+    }
+    {
+        auto buffer = make_shared_payload(from_shared, shared_released);
+        looper::write_udp(sender, destination, buffer, size, [&](looper::udp udp, const looper::error error) {
+            shared_released_early = shared_released;
+            on_written(udp, error);
+        });
+    }
+
+    CHECK(run_until(loop, [&]()->bool { return written == 3 && received.size() == 3; }));
+    CHECK(!failed);
+    CHECK(!shared_released_early);
+    CHECK(run_until(loop, [&]()->bool { return shared_released; }));
+
+    CHECK(received[0] == from_unique);
+    CHECK(received[1] == from_vector);
+    CHECK(received[2] == from_shared);
+
+    looper::destroy_udp(sender);
+    looper::destroy_udp(receiver);
+    looper::destroy(loop);
+}
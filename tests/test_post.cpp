@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <looper.h>
+
+#include "test.h"
+
+using namespace std::chrono_literals;
+
+template<typename pred_>
+static bool run_until(const looper::loop loop, pred_&& pred) {
+    const auto end = std::chrono::steady_clock::now() + 5s;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() >= end) {
+            return false;
+        }
+        looper::run_for(loop, 10ms);
+    }
+
+    return true;
+}
+
+LOOPER_TEST(post, post_at_runs_in_deadline_order) {
+    constexpr size_t count = 100;
+    constexpr size_t deadlines = 5;
+
+    const auto loop = looper::create();
+
+    // several callbacks share each deadline, and are posted interleaved with those of other deadlines
+    std::vector<size_t> order;
+    const auto base = std::chrono::steady_clock::now() + 20ms;
+    for (size_t i = 0; i < count; i++) {
+        const auto deadline = base + (deadlines - 1 - i % deadlines) * 5ms;
+        looper::post_at(loop, deadline, [&order, i](looper::loop) {
+            order.push_back(i);
+        });
+    }
+
+    CHECK(run_until(loop, [&]()->bool { return order.size() == count; }));
+
+    // latest deadline first in posting order, callbacks of the same deadline in the order they were posted
+    std::vector<size_t> expected(count);
+    for (size_t i = 0; i < count; i++) {
+        expected[i] = i;
+    }
+    std::stable_sort(expected.begin(), expected.end(), [](const size_t a, const size_t b)->bool {
+        return (deadlines - 1 - a % deadlines) < (deadlines - 1 - b % deadlines);
+    });
+    CHECK(order == expected);
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(post, post_at_does_not_run_early) {
+    const auto loop = looper::create();
+
+    std::chrono::steady_clock::time_point ran_at{};
+    const auto deadline = std::chrono::steady_clock::now() + 30ms;
+    looper::post_at(loop, deadline, [&ran_at](looper::loop) {
+        ran_at = std::chrono::steady_clock::now();
+    });
+
+    CHECK(run_until(loop, [&]()->bool { return ran_at != std::chrono::steady_clock::time_point{}; }));
+    CHECK(ran_at >= deadline);
+
+    looper::destroy(loop);
+}
+
+// futures are limited per loop, but posted callbacks take no handle, so any amount may be queued
+LOOPER_TEST(post, many_callbacks_in_flight) {
+    constexpr size_t count = 1000;
+
+    const auto loop = looper::create();
+
+    std::vector<size_t> order;
+    for (size_t i = 0; i < count; i++) {
+        if (i % 2 == 0) {
+            looper::post(loop, [&order, i](looper::loop) {
+                order.push_back(i);
+            });
+        } else {
+            looper::execute_later(loop, [&order, i](looper::loop) {
+                order.push_back(i);
+            });
+        }
+    }
+
+    CHECK(run_until(loop, [&]()->bool { return order.size() == count; }));
+    for (size_t i = 0; i < count; i++) {
+        CHECK(order[i] == i);
+    }
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(post, post_from_other_thread_runs_on_loop) {
+    constexpr size_t count = 100;
+
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    std::thread::id loop_thread;
+    CHECK(!looper::execute_later_and_wait(loop, [&loop_thread](looper::loop) {
+        loop_thread = std::this_thread::get_id();
+    }));
+    CHECK(loop_thread != std::thread::id());
+    CHECK(loop_thread != std::this_thread::get_id());
+
+    std::atomic<size_t> ran(0);
+    std::atomic<size_t> ran_elsewhere(0);
+    std::thread poster([&]()->void {
+        for (size_t i = 0; i < count; i++) {
+            looper::post(loop, [&](looper::loop) {
+                if (std::this_thread::get_id() != loop_thread) {
+                    ran_elsewhere++;
+                }
+                ran++;
+            });
+        }
+    });
+    poster.join();
+
+    CHECK(looper::tests::wait_for([&]()->bool { return ran.load() == count; }));
+    CHECK(ran_elsewhere.load() == 0);
+
+    looper::destroy(loop);
+}
@@ -0,0 +1,141 @@
+#include <chrono>
+#include <vector>
+
+#include <looper.h>
+
+#include "test.h"
+
+using namespace std::chrono_literals;
+
+static constexpr uint16_t tcp_port = 48001;
+static constexpr uint16_t udp_sender_port = 48002;
+static constexpr uint16_t udp_receiver_port = 48003;
+static constexpr size_t provided_buffer_size = 1024;
+
+template<typename pred_>
+static bool run_until(const looper::loop loop, pred_&& pred) {
+    for (int i = 0; i < 500 && !pred(); i++) {
+        looper::run_for(loop, 10ms);
+    }
+
+    return pred();
+}
+
+static bool is_within(const std::span<const uint8_t> data, const std::vector<uint8_t>& buffer) {
+    return data.data() >= buffer.data() && data.data() + data.size() <= buffer.data() + buffer.size();
+}
+
+// in level-triggered mode each event gives a single read, into the buffer the provider gave for it
+LOOPER_TEST(read_buffers, tcp_reads_into_provided_buffers) {
+    constexpr size_t size = 64 * 1024;
+
+    const auto loop = looper::create();
+
+    std::vector<uint8_t> buffers[2] = {std::vector<uint8_t>(provided_buffer_size), std::vector<uint8_t>(provided_buffer_size)};
+    size_t provided = 0;
+    size_t reads = 0;
+    bool failed = false;
+    std::vector<uint8_t> received;
+
+    looper::tcp accepted = looper::empty_handle;
+    const auto server = looper::create_tcp_server(loop);
+    looper::bind_tcp_server(server, "127.0.0.1", tcp_port);
+    looper::listen_tcp(server, 1, [&](const looper::tcp_server tcp_server) {
+        accepted = looper::accept_tcp(tcp_server);
+        looper::start_tcp_read(accepted, [&](looper::handle)->std::span<uint8_t> {
+            return buffers[provided++ % 2];
+        }, [&](looper::handle, const std::span<const uint8_t> data, const looper::error error) {
+            // the data is in the buffer given for this read
+            if (error != looper::error_success || !is_within(data, buffers[(provided - 1) % 2])) {
+                failed = true;
+                return;
+            }
+
+            reads++;
+            received.insert(received.end(), data.begin(), data.end());
+        });
+    });
+
+    bool connected = false;
+    const auto client = looper::create_tcp(loop);
+    looper::connect_tcp(client, "127.0.0.1", tcp_port, [&connected](looper::handle, const looper::error error) {
+        connected = error == looper::error_success;
+    });
+    CHECK(run_until(loop, [&]()->bool { return connected && accepted != looper::empty_handle; }));
+
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = static_cast<uint8_t>(i * 31);
+    }
+    looper::write_tcp(client, std::span<const uint8_t>(data), [](looper::handle, looper::error) {});
+
+    CHECK(run_until(loop, [&]()->bool { return received.size() == size || failed; }));
+    CHECK(!failed);
+    CHECK(received == data);
+    CHECK(reads >= size / provided_buffer_size);
+    CHECK(provided == reads);
+
+    looper::destroy_tcp(client);
+    looper::destroy_tcp(accepted);
+    looper::destroy_tcp_server(server);
+    looper::destroy(loop);
+}
+
+// a provider with no buffer to give returns an empty one. the read is then done into the loop's own buffer
+// and reported as usual, so the readable socket is drained rather than reported again and again.
+LOOPER_TEST(read_buffers, empty_provided_buffer_uses_loop_buffer) {
+    constexpr size_t count = 10;
+    constexpr size_t size = 32;
+
+    const auto loop = looper::create();
+
+    std::vector<uint8_t> buffer(provided_buffer_size);
+    size_t provided = 0;
+    bool failed = false;
+    std::vector<std::vector<uint8_t>> received;
+
+    const auto receiver = looper::create_udp(loop);
+    looper::bind_udp(receiver, udp_receiver_port);
+    looper::start_udp_read_endpoint(receiver, [&](looper::handle)->std::span<uint8_t> {
+        // only every other read gets a buffer
+        if (provided++ % 2 == 0) {
+            return {};
+        }
+        return buffer;
+    }, [&](looper::udp, looper::inet_endpoint, const std::span<const uint8_t> data, const looper::error error) {
+        const bool was_provided = (provided - 1) % 2 != 0;
+        if (error != looper::error_success || is_within(data, buffer) != was_provided) {
+            failed = true;
+            return;
+        }
+
+        received.emplace_back(data.begin(), data.end());
+    });
+
+    const auto sender = looper::create_udp(loop);
+    looper::bind_udp(sender, udp_sender_port);
+    const auto destination = looper::make_inet_endpoint({"127.0.0.1", udp_receiver_port});
+
+    for (size_t i = 0; i < count; i++) {
+        looper::write_udp(sender, destination, std::vector<uint8_t>(size, static_cast<uint8_t>(i)), [](looper::udp, looper::error) {});
+    }
+
+    CHECK(run_until(loop, [&]()->bool { return received.size() == count || failed; }));
+    CHECK(!failed);
+    for (size_t i = 0; i < count; i++) {
+        CHECK(received[i] == std::vector<uint8_t>(size, static_cast<uint8_t>(i)));
+    }
+    // one read per datagram, none of them retried
+    CHECK(provided == count);
+
+    // with nothing left to read, the loop goes idle
+    const auto before = looper::get_loop_stats(loop);
+    looper::run_for(loop, 50ms);
+    const auto after = looper::get_loop_stats(loop);
+    CHECK(provided == count);
+    CHECK(after.events == before.events);
+
+    looper::destroy_udp(sender);
+    looper::destroy_udp(receiver);
+    looper::destroy(loop);
+}
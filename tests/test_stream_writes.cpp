@@ -0,0 +1,245 @@
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include <looper.h>
+
+#include "test.h"
+
+static constexpr uint16_t port = 47601;
+static constexpr uint16_t inline_port = 47602;
+static constexpr uint16_t stats_port = 47603;
+static constexpr uint16_t merged_updates_port = 47604;
+
+using namespace std::chrono_literals;
+
+template<typename pred_>
+static bool run_until(const looper::loop loop, pred_&& pred) {
+    for (int i = 0; i < 500 && !pred(); i++) {
+        looper::run_for(loop, 10ms);
+    }
+
+    return pred();
+}
+
+// a zero-length write must still be completed when it is queued behind a partial write
+LOOPER_TEST(stream_writes, empty_write_behind_large_write_completes) {
+    constexpr size_t large_size = 16 * 1024 * 1024;
+
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    std::atomic<size_t> received{0};
+    std::atomic<looper::tcp> accepted{looper::empty_handle};
+    const auto server = looper::create_tcp_server(loop);
+    looper::bind_tcp_server(server, "127.0.0.1", port);
+    looper::listen_tcp(server, 1, [&](const looper::tcp_server tcp_server) {
+        const auto tcp = looper::accept_tcp(tcp_server);
+        accepted = tcp;
+        looper::start_tcp_read(tcp, [&received](looper::handle, const std::span<const uint8_t> data, const looper::error error) {
+            if (error == looper::error_success) {
+                received += data.size();
+            }
+        });
+    });
+
+    std::atomic<bool> connected{false};
+    const auto client = looper::create_tcp(loop);
+    looper::connect_tcp(client, "127.0.0.1", port, [&connected](looper::handle, const looper::error error) {
+        connected = error == looper::error_success;
+    });
+    CHECK(looper::tests::wait_for([&]()->bool { return connected && accepted != looper::empty_handle; }));
+
+    // the large write cannot fit in the socket buffers, so it stays queued while the empty write is added
+    std::atomic<int> completed{0};
+    std::atomic<int> large_order{-1};
+    std::atomic<int> empty_order{-1};
+    std::atomic<bool> failed{false};
+    looper::write_tcp(client, std::vector<uint8_t>(large_size, 0x5a), [&](looper::handle, const looper::error error) {
+        failed = failed || error != looper::error_success;
+        large_order = completed++;
+    });
+    looper::write_tcp(client, std::span<const uint8_t>{}, [&](looper::handle, const looper::error error) {
+        failed = failed || error != looper::error_success;
+        empty_order = completed++;
+    });
+
+    CHECK(looper::tests::wait_for([&]()->bool { return completed == 2; }));
+    CHECK(!failed);
+    CHECK(large_order == 0);
+    CHECK(empty_order == 1);
+    CHECK(looper::tests::wait_for([&]()->bool { return received == large_size; }));
+
+    // with nothing left to write, the loop should go idle instead of spinning on write events
+    const auto before = looper::get_loop_stats(loop);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const auto after = looper::get_loop_stats(loop);
+    CHECK(after.wakeups - before.wakeups < 10);
+
+    looper::destroy_tcp(client);
+    looper::destroy_tcp(accepted);
+    looper::destroy_tcp_server(server);
+    looper::destroy(loop);
+}
+
+// writes done right away, without waiting for the loop, still report to their callbacks only from the loop,
+// and in the order of the writes. this holds when a write is only partially done right away and the rest is queued.
+LOOPER_TEST(stream_writes, inline_writes_report_in_order) {
+    constexpr size_t small_size = 100;
+    constexpr size_t large_size = 16 * 1024 * 1024;
+
+    const auto loop = looper::create();
+
+    std::vector<uint8_t> received;
+    received.reserve(small_size * 2 + large_size);
+    looper::tcp accepted = looper::empty_handle;
+    const auto server = looper::create_tcp_server(loop);
+    looper::bind_tcp_server(server, "127.0.0.1", inline_port);
+    looper::listen_tcp(server, 1, [&](const looper::tcp_server tcp_server) {
+        accepted = looper::accept_tcp(tcp_server);
+        looper::start_tcp_read(accepted, [&received](looper::handle, const std::span<const uint8_t> data, const looper::error error) {
+            if (error == looper::error_success) {
+                received.insert(received.end(), data.begin(), data.end());
+            }
+        });
+    });
+
+    bool connected = false;
+    const auto client = looper::create_tcp(loop);
+    looper::connect_tcp(client, "127.0.0.1", inline_port, [&connected](looper::handle, const looper::error error) {
+        connected = error == looper::error_success;
+    });
+    CHECK(run_until(loop, [&]()->bool { return connected && accepted != looper::empty_handle; }));
+
+    std::vector<uint8_t> first(small_size, 0x01);
+    std::vector<uint8_t> large(large_size);
+    for (size_t i = 0; i < large_size; i++) {
+        large[i] = static_cast<uint8_t>(i * 7);
+    }
+    std::vector<uint8_t> last(small_size, 0x03);
+
+    std::vector<int> order;
+    bool failed = false;
+
+    // nothing is queued, so the first write is done right away, but its callback must wait for the loop
+    looper::write_tcp(client, std::span<const uint8_t>(first), [&](looper::handle, const looper::error error) {
+        failed = failed || error != looper::error_success;
+        order.push_back(0);
+    });
+    CHECK(order.empty());
+
+    // the large write cannot fit in the socket buffers, so only part of it is done right away
+    looper::write_tcp(client, std::span<const uint8_t>(large), [&](looper::handle, const looper::error error) {
+        failed = failed || error != looper::error_success;
+        order.push_back(1);
+    });
+    looper::write_tcp(client, std::span<const uint8_t>(last), [&](looper::handle, const looper::error error) {
+        failed = failed || error != looper::error_success;
+        order.push_back(2);
+    });
+    CHECK(order.empty());
+
+    CHECK(run_until(loop, [&]()->bool { return order.size() == 3 && received.size() == small_size * 2 + large_size; }));
+    CHECK(!failed);
+    CHECK((order == std::vector<int>{0, 1, 2}));
+
+    std::vector<uint8_t> expected;
+    expected.insert(expected.end(), first.begin(), first.end());
+    expected.insert(expected.end(), large.begin(), large.end());
+    expected.insert(expected.end(), last.begin(), last.end());
+    CHECK(received == expected);
+
+    looper::destroy_tcp(client);
+    looper::destroy_tcp(accepted);
+    looper::destroy_tcp_server(server);
+    looper::destroy(loop);
+}
+
+struct connected_pair {
+    looper::tcp_server server = looper::empty_handle;
+    looper::tcp client = looper::empty_handle;
+    looper::tcp accepted = looper::empty_handle;
+    std::vector<uint8_t> received;
+};
+
+// connects a client to a server on the loop, with the accepted end reading into received
+static void connect_pair(const looper::loop loop, const uint16_t port, connected_pair& pair) {
+    pair.server = looper::create_tcp_server(loop);
+    looper::bind_tcp_server(pair.server, "127.0.0.1", port);
+    looper::listen_tcp(pair.server, 1, [&pair](const looper::tcp_server tcp_server) {
+        pair.accepted = looper::accept_tcp(tcp_server);
+        looper::start_tcp_read(pair.accepted, [&pair](looper::handle, const std::span<const uint8_t> data, const looper::error error) {
+            if (error == looper::error_success) {
+                pair.received.insert(pair.received.end(), data.begin(), data.end());
+            }
+        });
+    });
+
+    bool connected = false;
+    pair.client = looper::create_tcp(loop);
+    looper::connect_tcp(pair.client, "127.0.0.1", port, [&connected](looper::handle, const looper::error error) {
+        connected = error == looper::error_success;
+    });
+    CHECK(run_until(loop, [&]()->bool { return connected && pair.accepted != looper::empty_handle; }));
+    // let the loop apply the event changes of connecting, so they are not counted by the test
+    looper::run_for(loop, 20ms);
+}
+
+static void destroy_pair(const connected_pair& pair) {
+    looper::destroy_tcp(pair.client);
+    looper::destroy_tcp(pair.accepted);
+    looper::destroy_tcp_server(pair.server);
+}
+
+// a write that is done right away never waits for the socket to be writable, so the poller is not asked
+// for write events, and neither is it asked to stop reporting them afterwards
+LOOPER_TEST(stream_writes, inline_write_does_not_update_poller) {
+    constexpr size_t size = 100;
+
+    const auto loop = looper::create();
+
+    connected_pair pair;
+    connect_pair(loop, stats_port, pair);
+
+    const std::vector<uint8_t> data(size, 0x11);
+    bool written = false;
+    bool failed = false;
+
+    const auto before = looper::get_loop_stats(loop);
+    looper::write_tcp(pair.client, std::span<const uint8_t>(data), [&](looper::handle, const looper::error error) {
+        failed = failed || error != looper::error_success;
+        written = true;
+    });
+    CHECK(run_until(loop, [&]()->bool { return written && pair.received.size() == size; }));
+    const auto after = looper::get_loop_stats(loop);
+
+    CHECK(!failed);
+    CHECK(pair.received == data);
+    CHECK(after.poller_updates == before.poller_updates);
+    CHECK(after.elided_poller_updates == before.elided_poller_updates);
+
+    destroy_pair(pair);
+    looper::destroy(loop);
+}
+
+// changes requested for one resource before the loop runs are merged, so the poller is updated once
+// with the result of all of them
+LOOPER_TEST(stream_writes, updates_of_one_iteration_are_merged) {
+    const auto loop = looper::create();
+
+    connected_pair pair;
+    connect_pair(loop, merged_updates_port, pair);
+
+    const auto before = looper::get_loop_stats(loop);
+    looper::stop_tcp_read(pair.accepted);
+    looper::start_tcp_read(pair.accepted, [](looper::handle, std::span<const uint8_t>, looper::error) {});
+    looper::stop_tcp_read(pair.accepted);
+    looper::run_for(loop, 10ms);
+    const auto after = looper::get_loop_stats(loop);
+
+    CHECK(after.poller_updates - before.poller_updates == 1);
+    CHECK(after.elided_poller_updates - before.elided_poller_updates == 2);
+
+    destroy_pair(pair);
+    looper::destroy(loop);
+}
@@ -0,0 +1,261 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <looper.h>
+
+#include "test.h"
+
+using namespace std::chrono_literals;
+
+LOOPER_TEST(timers, oneshot_fires_once_per_start) {
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    std::atomic<int> hits{0};
+    const auto timer = looper::create_timer(loop, 20ms, [&hits](looper::timer) {
+        hits++;
+    });
+
+    looper::start_timer(timer);
+    CHECK(looper::tests::wait_for([&]()->bool { return hits == 1; }));
+    std::this_thread::sleep_for(60ms);
+    CHECK(hits == 1);
+
+    looper::reset_timer(timer);
+    CHECK(looper::tests::wait_for([&]()->bool { return hits == 2; }));
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(timers, periodic_fires_without_reset) {
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    std::atomic<int> hits{0};
+    const auto timer = looper::create_timer(loop, 10ms, [&hits](looper::timer) {
+        hits++;
+    }, looper::timer_mode::periodic_skip);
+
+    looper::start_timer(timer);
+    CHECK(looper::tests::wait_for([&]()->bool { return hits >= 5; }));
+
+    looper::stop_timer(timer);
+    std::this_thread::sleep_for(20ms);
+    const auto stopped_hits = hits.load();
+    std::this_thread::sleep_for(50ms);
+    CHECK(hits == stopped_hits);
+
+    looper::destroy(loop);
+}
+
+// runs a periodic timer on a loop that is late by several periods, and returns how long after
+// the late run the next tick came.
+static std::chrono::nanoseconds next_tick_after_late_run(const looper::timer_mode mode, int& late_hits) {
+    constexpr auto period = 50ms;
+
+    const auto loop = looper::create();
+
+    int hits = 0;
+    std::chrono::steady_clock::time_point hit_time;
+    const auto timer = looper::create_timer(loop, period, [&](looper::timer) {
+        hits++;
+        hit_time = std::chrono::steady_clock::now();
+    }, mode);
+
+    looper::start_timer(timer);
+    std::this_thread::sleep_for(period * 5 + period / 5);
+
+    const auto late_run_time = std::chrono::steady_clock::now();
+    while (hits < 1) {
+        looper::run_once(loop);
+    }
+    late_hits = hits;
+
+    while (hits < 2) {
+        looper::run_once(loop);
+    }
+
+    looper::destroy(loop);
+    return hit_time - late_run_time;
+}
+
+LOOPER_TEST(timers, periodic_skip_stays_aligned_after_missed_ticks) {
+    int late_hits = 0;
+    const auto next_tick = next_tick_after_late_run(looper::timer_mode::periodic_skip, late_hits);
+
+    // the missed ticks produce one callback, and the next is on the original schedule
+    CHECK(late_hits == 1);
+    CHECK(next_tick < 50ms);
+}
+
+LOOPER_TEST(timers, periodic_coalesce_rebases_after_missed_ticks) {
+    int late_hits = 0;
+    const auto next_tick = next_tick_after_late_run(looper::timer_mode::periodic_coalesce, late_hits);
+
+    // the missed ticks produce one callback, and the next is a full period after it
+    CHECK(late_hits == 1);
+    CHECK(next_tick >= 50ms);
+}
+
+LOOPER_TEST(timers, slack_coalesces_close_timers) {
+    constexpr int count = 20;
+
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    std::atomic<int> hits{0};
+    std::vector<looper::timer> timers;
+    for (int i = 0; i < count; i++) {
+        timers.push_back(looper::create_timer(loop, 50ms + std::chrono::milliseconds(i), [&hits](looper::timer) {
+            hits++;
+        }, looper::timer_mode::oneshot, 30ms));
+    }
+
+    const auto before = looper::get_loop_stats(loop);
+    for (const auto timer : timers) {
+        looper::start_timer(timer);
+    }
+    CHECK(looper::tests::wait_for([&]()->bool { return hits == count; }));
+    const auto after = looper::get_loop_stats(loop);
+
+    // all timeouts fall within the slack of the first, so they should share very few wakeups
+    const auto wakeups = after.timer_wakeups - before.timer_wakeups;
+    const auto coalesced = after.coalesced_timer_wakeups - before.coalesced_timer_wakeups;
+    CHECK(wakeups <= 2);
+    CHECK(coalesced >= count - 2);
+    CHECK(coalesced < static_cast<uint64_t>(count));
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(timers, slack_never_fires_early) {
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    std::atomic<bool> hit{false};
+    std::chrono::steady_clock::time_point hit_time;
+    const auto timer = looper::create_timer(loop, 30ms, [&](looper::timer) {
+        hit_time = std::chrono::steady_clock::now();
+        hit = true;
+    }, looper::timer_mode::oneshot, 20ms);
+
+    const auto start = std::chrono::steady_clock::now();
+    looper::start_timer(timer);
+    CHECK(looper::tests::wait_for([&]()->bool { return hit.load(); }));
+    CHECK(hit_time - start >= 30ms);
+
+    looper::destroy(loop);
+}
+
+// the loop sleeps until the latest time the slack of its timers allows. a timer started later from another
+// thread may be due before that even though it is not the first timer, and must wake the loop.
+LOOPER_TEST(timers, later_timer_without_slack_wakes_slack_sleep) {
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    const auto slack_timer = looper::create_timer(loop, 100ms, [](looper::timer) {}, looper::timer_mode::oneshot, 2s);
+    looper::start_timer(slack_timer);
+    std::this_thread::sleep_for(20ms);
+
+    std::atomic<bool> hit{false};
+    std::chrono::steady_clock::time_point hit_time;
+    const auto timer = looper::create_timer(loop, 200ms, [&](looper::timer) {
+        hit_time = std::chrono::steady_clock::now();
+        hit = true;
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    looper::start_timer(timer);
+    CHECK(looper::tests::wait_for([&]()->bool { return hit.load(); }));
+    CHECK(hit_time - start >= 200ms);
+    CHECK(hit_time - start < 1000ms);
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(timers, negative_slack_is_rejected) {
+    const auto loop = looper::create();
+
+    bool rejected = false;
+    try {
+        looper::create_timer(loop, 20ms, [](looper::timer) {}, looper::timer_mode::oneshot, -1ms);
+    } catch (const looper::os_exception& e) {
+        rejected = e.get_code() == looper::error_invalid_argument;
+    }
+    CHECK(rejected);
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(timers, timers_without_slack_are_not_coalesced) {
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    std::atomic<int> hits{0};
+    const auto first = looper::create_timer(loop, 20ms, [&hits](looper::timer) {
+        hits++;
+    });
+    const auto second = looper::create_timer(loop, 40ms, [&hits](looper::timer) {
+        hits++;
+    });
+
+    const auto before = looper::get_loop_stats(loop);
+    looper::start_timer(first);
+    looper::start_timer(second);
+    CHECK(looper::tests::wait_for([&]()->bool { return hits == 2; }));
+    const auto after = looper::get_loop_stats(loop);
+
+    CHECK(after.timer_wakeups - before.timer_wakeups == 2);
+    CHECK(after.coalesced_timer_wakeups == before.coalesced_timer_wakeups);
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(timers, idle_loop_does_not_wake) {
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+    std::this_thread::sleep_for(50ms);
+
+    // with nothing to do, the loop waits for events without a timeout
+    const auto before = looper::get_loop_stats(loop);
+    std::this_thread::sleep_for(1200ms);
+    const auto after = looper::get_loop_stats(loop);
+    CHECK(after.wakeups == before.wakeups);
+    CHECK(after.idle_wakeups == before.idle_wakeups);
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(timers, idle_loop_wakes_only_for_deadline) {
+    const auto loop = looper::create();
+    looper::exec_in_thread(loop);
+
+    std::atomic<int> hits{0};
+    const auto timer = looper::create_timer(loop, 1200ms, [&hits](looper::timer) {
+        hits++;
+    });
+    looper::start_timer(timer);
+    std::this_thread::sleep_for(50ms);
+
+    const auto before = looper::get_loop_stats(loop);
+    CHECK(looper::tests::wait_for([&]()->bool { return hits == 1; }));
+    const auto after = looper::get_loop_stats(loop);
+    CHECK(after.idle_wakeups == before.idle_wakeups);
+    CHECK(after.timer_wakeups == before.timer_wakeups + 1);
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(timers, run_for_returns_on_idle_loop) {
+    const auto loop = looper::create();
+
+    const auto start = std::chrono::steady_clock::now();
+    looper::run_for(loop, 50ms);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    CHECK(elapsed >= 50ms);
+    CHECK(elapsed < 500ms);
+
+    looper::destroy(loop);
+}
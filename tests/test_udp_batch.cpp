@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <vector>
+
+#include <looper.h>
+
+#include "test.h"
+
+using namespace std::chrono_literals;
+
+static constexpr uint16_t sender_port = 47801;
+static constexpr uint16_t receiver_ports[] = {47802, 47803, 47804};
+static constexpr size_t receiver_count = std::size(receiver_ports);
+static constexpr uint16_t batch_sender_ports[] = {47805, 47806};
+static constexpr size_t batch_sender_count = std::size(batch_sender_ports);
+static constexpr uint16_t batch_receiver_port = 47807;
+
+template<typename pred_>
+static bool run_until(const looper::loop loop, pred_&& pred) {
+    for (int i = 0; i < 500 && !pred(); i++) {
+        looper::run_for(loop, 10ms);
+    }
+
+    return pred();
+}
+
+// each message of a batch goes to its own endpoint, and arrives there from the sender's address
+LOOPER_TEST(udp_batch, batch_write_reaches_each_endpoint) {
+    constexpr size_t messages_per_receiver = 3;
+
+    const auto loop = looper::create();
+
+    const auto sender = looper::create_udp(loop);
+    looper::bind_udp(sender, sender_port);
+
+    bool failed = false;
+    std::vector<std::vector<uint8_t>> received[receiver_count];
+    looper::udp receivers[receiver_count];
+    for (size_t i = 0; i < receiver_count; i++) {
+        receivers[i] = looper::create_udp(loop);
+        looper::bind_udp(receivers[i], receiver_ports[i]);
+        looper::start_udp_read_endpoint(receivers[i], [&, i](looper::udp, const looper::inet_endpoint from, const std::span<const uint8_t> data, const looper::error error) {
+            const auto address = looper::to_inet_address(from);
+            if (error != looper::error_success || address.ip != "127.0.0.1" || address.port != sender_port) {
+                failed = true;
+                return;
+            }
+
+            received[i].emplace_back(data.begin(), data.end());
+        });
+    }
+
+    // messages to the receivers are interleaved, and each holds its receiver and index
+    std::vector<std::vector<uint8_t>> payloads;
+    std::vector<looper::udp_message> messages;
+    for (size_t n = 0; n < messages_per_receiver; n++) {
+        for (size_t i = 0; i < receiver_count; i++) {
+            payloads.push_back(std::vector<uint8_t>(16 + n, static_cast<uint8_t>(i * 16 + n)));
+        }
+    }
+    for (size_t index = 0; index < payloads.size(); index++) {
+        const auto endpoint = looper::make_inet_endpoint({"127.0.0.1", receiver_ports[index % receiver_count]});
+        messages.push_back(looper::udp_message{endpoint, payloads[index]});
+    }
+
+    size_t written = 0;
+    looper::write_udp_batch(sender, messages, [&](looper::udp, const looper::error error) {
+        failed = failed || error != looper::error_success;
+        written++;
+    });
+
+    CHECK(run_until(loop, [&]()->bool {
+        size_t total = 0;
+        for (const auto& datagrams : received) {
+            total += datagrams.size();
+        }
+        return (written == messages.size() && total == messages.size()) || failed;
+    }));
+    CHECK(!failed);
+
+    for (size_t i = 0; i < receiver_count; i++) {
+        CHECK(received[i].size() == messages_per_receiver);
+        for (size_t n = 0; n < messages_per_receiver; n++) {
+            CHECK(received[i][n] == std::vector<uint8_t>(16 + n, static_cast<uint8_t>(i * 16 + n)));
+        }
+    }
+
+    for (const auto receiver : receivers) {
+        looper::destroy_udp(receiver);
+    }
+    looper::destroy_udp(sender);
+    looper::destroy(loop);
+}
+
+// a datagram sent by one of the batch senders, holding its sender and index
+static std::vector<uint8_t> batch_payload(const size_t sender, const size_t index) {
+    std::vector<uint8_t> payload(8 + index % 8, static_cast<uint8_t>(index));
+    payload[0] = static_cast<uint8_t>(sender);
+    return payload;
+}
+
+struct batch_receiver {
+    looper::udp udp = looper::empty_handle;
+    size_t callbacks = 0;
+    size_t largest_batch = 0;
+    bool failed = false;
+    // per sender, in the order received
+    std::vector<std::vector<uint8_t>> received[batch_sender_count];
+
+    [[nodiscard]] size_t total() const {
+        size_t total = 0;
+        for (const auto& datagrams : received) {
+            total += datagrams.size();
+        }
+        return total;
+    }
+
+    void start(const size_t batch_size) {
+        looper::start_udp_read_batch(udp, [this](looper::udp, const std::span<const looper::udp_datagram> datagrams, const looper::error error) {
+            if (error != looper::error_success) {
+                failed = true;
+                return;
+            }
+
+            callbacks++;
+            largest_batch = std::max(largest_batch, datagrams.size());
+            for (const auto& datagram : datagrams) {
+                const auto address = looper::to_inet_address(datagram.sender);
+                const auto it = std::find(std::begin(batch_sender_ports), std::end(batch_sender_ports), address.port);
+                const auto sender = static_cast<size_t>(it - std::begin(batch_sender_ports));
+                if (address.ip != "127.0.0.1" || it == std::end(batch_sender_ports) ||
+                    datagram.data.empty() || datagram.data[0] != sender) {
+                    failed = true;
+                    continue;
+                }
+
+                received[sender].emplace_back(datagram.data.begin(), datagram.data.end());
+            }
+        }, batch_size);
+    }
+};
+
+// sends count datagrams from each sender, alternating between them, and waits until all were written
+static void send_batch_datagrams(const looper::loop loop, const looper::udp* senders, const size_t first, const size_t count,
+                                 std::vector<std::vector<uint8_t>>& payloads) {
+    size_t written = 0;
+    bool failed = false;
+    for (size_t index = first; index < first + count; index++) {
+        for (size_t sender = 0; sender < batch_sender_count; sender++) {
+            payloads.push_back(batch_payload(sender, index));
+        }
+    }
+    for (size_t index = payloads.size() - count * batch_sender_count; index < payloads.size(); index++) {
+        looper::write_udp(senders[index % batch_sender_count], {"127.0.0.1", batch_receiver_port}, payloads[index],
+                          [&](looper::udp, const looper::error error) {
+            failed = failed || error != looper::error_success;
+            written++;
+        });
+    }
+
+    CHECK(run_until(loop, [&]()->bool { return written == count * batch_sender_count || failed; }));
+    CHECK(!failed);
+}
+
+// more datagrams are waiting than fit in one batch, so they are received over several batches. each is
+// given intact, with its own sender, and in the order sent by that sender.
+LOOPER_TEST(udp_batch, batch_read_spans_several_batches) {
+    constexpr size_t batch_size = 8;
+    constexpr size_t datagrams_per_sender = 20;
+
+    const auto loop = looper::create();
+
+    looper::udp senders[batch_sender_count];
+    for (size_t i = 0; i < batch_sender_count; i++) {
+        senders[i] = looper::create_udp(loop);
+        looper::bind_udp(senders[i], batch_sender_ports[i]);
+    }
+
+    batch_receiver receiver;
+    receiver.udp = looper::create_udp(loop);
+    looper::bind_udp(receiver.udp, batch_receiver_port);
+
+    // everything is queued on the receiving socket before reading starts
+    std::vector<std::vector<uint8_t>> payloads;
+    send_batch_datagrams(loop, senders, 0, datagrams_per_sender, payloads);
+
+    receiver.start(batch_size);
+    CHECK(run_until(loop, [&]()->bool {
+        return receiver.total() == datagrams_per_sender * batch_sender_count || receiver.failed;
+    }));
+    CHECK(!receiver.failed);
+    CHECK(receiver.largest_batch == batch_size);
+    CHECK(receiver.callbacks >= (datagrams_per_sender * batch_sender_count) / batch_size);
+
+    for (size_t sender = 0; sender < batch_sender_count; sender++) {
+        CHECK(receiver.received[sender].size() == datagrams_per_sender);
+        for (size_t index = 0; index < datagrams_per_sender; index++) {
+            CHECK(receiver.received[sender][index] == batch_payload(sender, index));
+        }
+    }
+
+    looper::destroy_udp(receiver.udp);
+    for (const auto sender : senders) {
+        looper::destroy_udp(sender);
+    }
+    looper::destroy(loop);
+}
+
+// fewer datagrams are waiting than fit in a batch. they are given without waiting for the batch to fill,
+// and reading continues for datagrams sent afterwards.
+LOOPER_TEST(udp_batch, batch_read_partial_batch) {
+    constexpr size_t batch_size = 16;
+    constexpr size_t first_datagrams = 3;
+    constexpr size_t second_datagrams = 2;
+
+    const auto loop = looper::create();
+
+    looper::udp senders[batch_sender_count];
+    for (size_t i = 0; i < batch_sender_count; i++) {
+        senders[i] = looper::create_udp(loop);
+        looper::bind_udp(senders[i], batch_sender_ports[i]);
+    }
+
+    batch_receiver receiver;
+    receiver.udp = looper::create_udp(loop);
+    looper::bind_udp(receiver.udp, batch_receiver_port);
+    receiver.start(batch_size);
+
+    std::vector<std::vector<uint8_t>> payloads;
+    send_batch_datagrams(loop, senders, 0, first_datagrams, payloads);
+    CHECK(run_until(loop, [&]()->bool {
+        return receiver.total() == first_datagrams * batch_sender_count || receiver.failed;
+    }));
+
+    send_batch_datagrams(loop, senders, first_datagrams, second_datagrams, payloads);
+    CHECK(run_until(loop, [&]()->bool {
+        return receiver.total() == (first_datagrams + second_datagrams) * batch_sender_count || receiver.failed;
+    }));
+    CHECK(!receiver.failed);
+    CHECK(receiver.largest_batch < batch_size);
+
+    for (size_t sender = 0; sender < batch_sender_count; sender++) {
+        CHECK(receiver.received[sender].size() == first_datagrams + second_datagrams);
+        for (size_t index = 0; index < first_datagrams + second_datagrams; index++) {
+            CHECK(receiver.received[sender][index] == batch_payload(sender, index));
+        }
+    }
+
+    looper::destroy_udp(receiver.udp);
+    for (const auto sender : senders) {
+        looper::destroy_udp(sender);
+    }
+    looper::destroy(loop);
+}
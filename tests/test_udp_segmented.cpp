@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <looper.h>
+
+#include "test.h"
+
+static constexpr uint16_t plain_port = 47501;
+static constexpr uint16_t segmented_port = 47502;
+static constexpr uint16_t read_mode_port = 47503;
+static constexpr uint16_t truncated_port = 47504;
+
+static std::vector<uint8_t> make_payload(const size_t size) {
+    std::vector<uint8_t> payload(size);
+    for (size_t i = 0; i < size; i++) {
+        payload[i] = static_cast<uint8_t>(i);
+    }
+    return payload;
+}
+
+static bool is_invalid_argument(const std::function<void()>& func) {
+    try {
+        func();
+    } catch (const looper::os_exception& e) {
+        return e.get_code() == looper::error_invalid_argument;
+    }
+
+    return false;
+}
+
+LOOPER_TEST(udp_segmented, segmented_write_received_as_datagrams) {
+    constexpr size_t segment_size = 1000;
+    constexpr size_t size = segment_size * 20 + 500;
+
+    const auto loop = looper::create();
+    const auto receiver = looper::create_udp(loop);
+    const auto sender = looper::create_udp(loop);
+    looper::bind_udp(receiver, plain_port);
+
+    std::atomic<size_t> received{0};
+    std::atomic<size_t> received_size{0};
+    std::atomic<bool> failed{false};
+    looper::start_udp_read_endpoint(receiver, [&](looper::udp, looper::inet_endpoint, const std::span<const uint8_t> data, const looper::error error) {
+        if (error != looper::error_success) {
+            failed = true;
+            return;
+        }
+
+        // all segments are full except the last
+        if (data.size() != segment_size && !(data.size() == 500 && received == 20)) {
+            failed = true;
+        }
+        received_size += data.size();
+        received++;
+    });
+    looper::exec_in_thread(loop);
+
+    std::atomic<bool> written{false};
+    std::atomic<looper::error> write_error{looper::error_success};
+    looper::write_udp_segmented(sender, {"127.0.0.1", plain_port}, make_payload(size), segment_size, [&](looper::udp, const looper::error error) {
+        write_error = error;
+        written = true;
+    });
+
+    CHECK(looper::tests::wait_for([&]()->bool { return written.load(); }));
+    if (write_error == looper::error_operation_not_supported) {
+        // no segmentation offload in this os
+        looper::destroy(loop);
+        return;
+    }
+
+    CHECK(write_error == looper::error_success);
+    CHECK(looper::tests::wait_for([&]()->bool { return received == 21 || failed; }));
+    CHECK(!failed);
+    CHECK(received_size == size);
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(udp_segmented, segmented_read_receives_coalesced_datagrams) {
+    constexpr size_t segment_size = 1000;
+    constexpr size_t segments = 40;
+
+    const auto loop = looper::create();
+    const auto receiver = looper::create_udp(loop);
+    const auto sender = looper::create_udp(loop);
+    looper::bind_udp(receiver, segmented_port);
+
+    const auto expected_data = make_payload(segment_size);
+    std::atomic<size_t> received{0};
+    std::atomic<bool> failed{false};
+    try {
+        looper::start_udp_read_segmented(receiver, [&](looper::udp, const looper::inet_endpoint sender, const std::span<const uint8_t> data,
+                                                       const size_t read_segment_size, const looper::error error) {
+            if (error != looper::error_success || read_segment_size != segment_size || data.size() % segment_size != 0) {
+                failed = true;
+                return;
+            }
+            if (looper::to_inet_address(sender).ip != "127.0.0.1") {
+                failed = true;
+            }
+
+            for (size_t offset = 0; offset < data.size(); offset += segment_size) {
+                if (!std::equal(expected_data.begin(), expected_data.end(), data.begin() + offset)) {
+                    failed = true;
+                }
+            }
+            received += data.size() / segment_size;
+        });
+    } catch (const looper::os_exception& e) {
+        CHECK(e.get_code() == looper::error_operation_not_supported);
+        looper::destroy(loop);
+        return;
+    }
+    looper::exec_in_thread(loop);
+
+    // the same segment repeated, so each datagram can be verified on its own
+    std::vector<uint8_t> payload;
+    for (size_t i = 0; i < segments; i++) {
+        payload.insert(payload.end(), expected_data.begin(), expected_data.end());
+    }
+
+    const auto destination = looper::make_inet_endpoint({"127.0.0.1", segmented_port});
+    std::atomic<looper::error> write_error{looper::error_success};
+    looper::write_udp_segmented(sender, destination, payload, segment_size, [&](looper::udp, const looper::error error) {
+        write_error = error;
+    });
+
+    CHECK(looper::tests::wait_for([&]()->bool { return received == segments || failed || write_error != looper::error_success; }));
+    CHECK(write_error == looper::error_success);
+    CHECK(!failed);
+    CHECK(received == segments);
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(udp_segmented, out_of_range_writes_rejected) {
+    const auto loop = looper::create();
+    const auto udp = looper::create_udp(loop);
+    const looper::inet_address_view destination{"127.0.0.1", plain_port};
+
+    // segment larger than a datagram may be
+    CHECK(is_invalid_argument([&]()->void {
+        looper::write_udp_segmented(udp, destination, make_payload(100), 70000, [](looper::udp, looper::error) {});
+    }));
+    // too many segments
+    CHECK(is_invalid_argument([&]()->void {
+        looper::write_udp_segmented(udp, destination, make_payload(650), 10, [](looper::udp, looper::error) {});
+    }));
+    // too much data in total
+    CHECK(is_invalid_argument([&]()->void {
+        looper::write_udp_segmented(udp, destination, make_payload(66000), 60000, [](looper::udp, looper::error) {});
+    }));
+
+    looper::destroy(loop);
+}
+
+LOOPER_TEST(udp_segmented, second_read_mode_rejected_while_reading) {
+    const auto loop = looper::create();
+    const auto receiver = looper::create_udp(loop);
+    const auto sender = looper::create_udp(loop);
+    looper::bind_udp(receiver, read_mode_port);
+
+    std::atomic<size_t> received{0};
+    std::atomic<bool> failed{false};
+    looper::start_udp_read_batch(receiver, [&](looper::udp, const std::span<const looper::udp_datagram> datagrams, const looper::error error) {
+        if (error != looper::error_success) {
+            failed = true;
+            return;
+        }
+        received += datagrams.size();
+    });
+
+    // switching the mode while reading must fail without touching the running read
+    bool already_reading = false;
+    try {
+        looper::start_udp_read_segmented(receiver, [&](looper::udp, looper::inet_endpoint, std::span<const uint8_t>, size_t, looper::error) {
+            failed = true;
+        });
+    } catch (const looper::os_exception& e) {
+        already_reading = e.get_code() == looper::error_already_reading;
+    }
+    CHECK(already_reading);
+
+    looper::exec_in_thread(loop);
+
+    for (int i = 0; i < 10; i++) {
+        looper::write_udp(sender, {"127.0.0.1", read_mode_port}, make_payload(100), [](looper::udp, looper::error) {});
+    }
+
+    CHECK(looper::tests::wait_for([&]()->bool { return received == 10 || failed; }));
+    CHECK(!failed);
+
+    looper::destroy(loop);
+}
+
+// a read larger than the space for it would be truncated. it is dropped instead of given partially, and
+// reading goes on with the next datagram.
+LOOPER_TEST(udp_segmented, truncated_read_dropped) {
+    constexpr size_t max_read_size = 2048;
+    constexpr size_t large_size = 4000;
+    constexpr size_t small_size = 100;
+
+    const auto loop = looper::create();
+    const auto receiver = looper::create_udp(loop);
+    const auto sender = looper::create_udp(loop);
+    looper::bind_udp(receiver, truncated_port);
+
+    std::atomic<bool> failed{false};
+    std::vector<std::vector<uint8_t>> received;
+    std::atomic<size_t> received_count{0};
+    try {
+        looper::start_udp_read_segmented(receiver, [&](looper::udp, looper::inet_endpoint, const std::span<const uint8_t> data,
+                                                       size_t, const looper::error error) {
+            if (error != looper::error_success) {
+                failed = true;
+                return;
+            }
+
+            received.emplace_back(data.begin(), data.end());
+            received_count++;
+        }, max_read_size);
+    } catch (const looper::os_exception& e) {
+        CHECK(e.get_code() == looper::error_operation_not_supported);
+        looper::destroy(loop);
+        return;
+    }
+
+    const auto small = make_payload(small_size);
+    looper::write_udp(sender, {"127.0.0.1", truncated_port}, make_payload(large_size), [](looper::udp, looper::error) {});
+    looper::write_udp(sender, {"127.0.0.1", truncated_port}, small, [](looper::udp, looper::error) {});
+
+    looper::exec_in_thread(loop);
+    CHECK(looper::tests::wait_for([&]()->bool { return received_count == 1 || failed; }));
+    // nothing else arrives late
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(!failed);
+    CHECK(received_count == 1);
+    CHECK(received[0] == small);
+
+    looper::destroy(loop);
+}